@@ -0,0 +1,50 @@
+#include <MAX3010x.h>
+#include <MAX3010x_analyzer.h>
+
+// Sensor (adjust to your sensor type)
+MAX30105 sensor;
+const auto kSamplingRate = sensor.SAMPLING_RATE_400SPS;
+const float kSamplingFrequency = 400.0;
+
+// Set to 1 to stream the raw FIFO bytes instead of the results, e.g. to record files for
+// the offline analysis (extras/linux/batchAnalysis.cpp), which runs the same analyzer code
+#define RECORD 0
+
+// Heart rate, SpO2 and signal quality (~2.5 KB RAM, use a board with enough memory)
+MAX3010xAnalyzer<> analyzer(kSamplingFrequency);
+
+void setup() {
+  Serial.begin(115200);
+
+  if(sensor.begin(sensor.BUS_CLOCK_FAST) && sensor.setSamplingRate(kSamplingRate)) {
+#if !RECORD
+    Serial.println("Sensor initialized");
+#endif
+  }
+  else {
+    Serial.println("Sensor not found");
+    while(1);
+  }
+}
+
+void loop() {
+  sensor.poll([](const MAX3010xRawData& raw) {
+#if RECORD
+    Serial.write(raw.data, raw.samples * raw.slots * raw.sampleSize);
+#else
+    analyzer.process(raw, [](const MAX3010xAnalyzer<>& result) {
+      if(!result.usable()) {
+        Serial.println("No finger or poor signal");
+        return;
+      }
+
+      Serial.print("Heart Rate (bpm): ");
+      Serial.println(result.bpm());
+      Serial.print("SpO2 (%): ");
+      Serial.println(result.spo2() / 256.0);
+      Serial.print("Perfusion Index (%): ");
+      Serial.println(result.ir().perfusionIndex());
+    });
+#endif
+  });
+}
@@ -0,0 +1,61 @@
+#include <MAX3010x.h>
+
+// Sensor (adjust to your sensor type)
+MAX30105 sensor;
+
+// Sensor supply switched by a pin, the sensor cold-starts for every measurement
+const int kPowerPin = 7;
+const int kSamplesPerMeasurement = 100;
+const unsigned long kMeasurementIntervalMs = 10000;
+const unsigned long kPowerUpMs = 10;      // Supply settling before the first transfer and between attempts
+const int kStartAttempts = 3;
+
+// Configuration of the first measurement, applied as the first configuration afterwards
+MAX3010xConfiguration configuration;
+bool configurationSaved = false;
+
+bool configure() {
+  if(configurationSaved) return sensor.begin(configuration, sensor.BUS_CLOCK_FAST);
+
+  configurationSaved = sensor.begin(sensor.BUS_CLOCK_FAST) && sensor.setMode(sensor.MODE_SPO2) &&
+                       sensor.setSamplingRate(sensor.SAMPLING_RATE_400SPS) && sensor.saveConfiguration(configuration);
+  return configurationSaved;
+}
+
+// Waits for the supply to settle and retries the startup while the sensor doesn't respond yet
+bool start() {
+  for(int attempt = 0; attempt < kStartAttempts; attempt++) {
+    delay(kPowerUpMs);
+    if(configure()) return true;
+  }
+  return false;
+}
+
+void setup() {
+  Serial.begin(115200);
+  pinMode(kPowerPin, OUTPUT);
+}
+
+void loop() {
+  digitalWrite(kPowerPin, HIGH);
+
+  if(start()) {
+    for(int i = 0; i < kSamplesPerMeasurement; i++) {
+      auto sample = sensor.readSample(100);
+      if(!sample.valid) break;
+      // Process sample.red and sample.ir
+    }
+
+    const MAX3010xDiagnostics& diagnostics = sensor.diagnostics();
+    Serial.print("Startup (us): ");
+    Serial.print(diagnostics.startupMicros);
+    Serial.print(", first sample (us): ");
+    Serial.println(diagnostics.firstSampleMicros);
+  }
+  else {
+    Serial.println("Sensor not found");
+  }
+
+  digitalWrite(kPowerPin, LOW);
+  delay(kMeasurementIntervalMs);
+}
@@ -0,0 +1,48 @@
+#include <MAX3010x.h>
+
+// Sensor (adjust to your sensor type)
+MAX30105 sensor;
+
+// Configuration snapshot (could also be kept in EEPROM)
+MAX3010xConfiguration configuration;
+
+void setup() {
+  Serial.begin(115200);
+
+  if(sensor.begin() && sensor.setMode(sensor.MODE_SPO2) && sensor.setSamplingRate(sensor.SAMPLING_RATE_400SPS) &&
+     sensor.setLedCurrent(sensor.LED_RED, 100) && sensor.saveConfiguration(configuration)) {
+    Serial.println("Sensor initialized");
+  }
+  else {
+    Serial.println("Sensor not found");
+    while(1);
+  }
+
+  // Compare the recovery with the default configuration and with the snapshot
+  unsigned long start = micros();
+  sensor.reset();
+  unsigned long defaultMicros = micros() - start;
+
+  start = micros();
+  if(!sensor.reset(configuration)) Serial.println("Restore failed");
+  unsigned long restoreMicros = micros() - start;
+
+  Serial.print("Reset with default configuration (us): ");
+  Serial.println(defaultMicros);
+  Serial.print("Reset with restored configuration (us): ");
+  Serial.println(restoreMicros);
+}
+
+void loop() {
+  // The power ready flag is set after a brown-out, the sensor is back at its defaults
+  if(sensor.checkInterruptFlag(sensor.INT_PWR_RDY)) {
+    Serial.println(sensor.restoreConfiguration(configuration) ? "Configuration restored" : "Restore failed");
+  }
+
+  auto sample = sensor.readSample(1000);
+  if(sample.valid) {
+    Serial.print(sample.red);
+    Serial.print(",");
+    Serial.println(sample.ir);
+  }
+}
@@ -0,0 +1,175 @@
+#include <MAX3010x.h>
+#include <MAX3010x_decimator.h>
+#include <MAX3010x_spectralHeartRate.h>
+#include <MAX3010x_signalQuality.h>
+#include "filters.h"
+
+// Sensor (MAX30101 or MAX30105)
+MAX30105 sensor;
+
+// Acquisition profile: Green for the heart rate, red and IR for SpO2 from one multi LED stream
+MAX30105::MultiLedConfiguration cfg = {
+  MAX30105::SLOT_GREEN, 
+  MAX30105::SLOT_RED, 
+  MAX30105::SLOT_IR, 
+  MAX30105::SLOT_OFF
+};
+const uint8_t kGreenSlot = 0;
+const uint8_t kRedSlot = 1;
+const uint8_t kIrSlot = 2;
+
+// Green has a much larger pulsatile component than red, a low current and sampling rate is sufficient
+const auto kSamplingRate = sensor.SAMPLING_RATE_100SPS;
+const float kSamplingFrequency = 100.0;
+const uint8_t kGreenCurrent = 25;   // 5 mA
+const uint8_t kRedCurrent = 90;     // 18 mA
+const uint8_t kIrCurrent = 80;      // 16 mA
+const float kPulseWidth = 411e-6;   // 18 bit resolution
+
+// Reference: red-only pipeline of the SpO2 example (400 SPS, red 18 mA, IR 16 mA)
+const float kReferenceLedCurrent = 400 * kPulseWidth * (18.0 + 16.0);
+
+// Heart rate: Decimation to 12.5 Hz, spectral estimate over 10.24 s (34 bins)
+const uint8_t kDecimation = 8;
+MAX3010xDecimator<16> decimator(kDecimation);
+MAX3010xSpectralHeartRate<128, 36> heart_rate(kSamplingFrequency / kDecimation);
+
+// SpO2: Perfusion index of red and IR, R = PI(red) / PI(IR)
+MAX3010xSignalQuality quality_green(kSamplingFrequency);
+MAX3010xSignalQuality quality_red(kSamplingFrequency);
+MAX3010xSignalQuality quality_ir(kSamplingFrequency);
+
+// R value to SpO2 calibration factors
+// See https://www.maximintegrated.com/en/design/technical-documents/app-notes/6/6845.html
+float kSpO2_A = 1.5958422;
+float kSpO2_B = -34.6596622;
+float kSpO2_C = 112.6898759;
+
+// Reference pipeline of the SpO2 example (filters, statistics and beat detection on red), timed on the same data
+const bool kTimeReference = true;
+const float kReferenceSamplingFrequency = 400.0;
+LowPassFilter low_pass_filter_red(5.0, kReferenceSamplingFrequency);
+LowPassFilter low_pass_filter_ir(5.0, kReferenceSamplingFrequency);
+HighPassFilter high_pass_filter(0.5, kReferenceSamplingFrequency);
+Differentiator differentiator(kReferenceSamplingFrequency);
+MinMaxAvgStatistic stat_red;
+MinMaxAvgStatistic stat_ir;
+float last_diff = NAN;
+unsigned long reference_crossings = 0;
+
+// Output interval and processing time statistic
+const unsigned long kOutputIntervalMs = 1000;
+unsigned long last_output = 0;
+unsigned long processing_us = 0;
+unsigned long reference_us = 0;
+unsigned long processed_samples = 0;
+
+void setup() {
+  Serial.begin(115200);
+
+  if(sensor.begin() && 
+     sensor.setMultiLedConfiguration(cfg) &&
+     sensor.setLedCurrent(MAX30105::LED_GREEN, kGreenCurrent) &&
+     sensor.setLedCurrent(MAX30105::LED_RED, kRedCurrent) &&
+     sensor.setLedCurrent(MAX30105::LED_IR, kIrCurrent) &&
+     sensor.setSamplingRate(kSamplingRate) &&
+     sensor.setMode(MAX30105::MODE_MULTI_LED)) { 
+    Serial.println("Sensor initialized");
+  }
+  else {
+    Serial.println("Sensor not found");  
+    while(1);
+  }
+
+  // Average LED current: Sampling rate * pulse width * sum of LED currents
+  float led_current = kSamplingFrequency * kPulseWidth * (kGreenCurrent + kRedCurrent + kIrCurrent) * 0.2;
+  Serial.print("Average LED current (mA): ");
+  Serial.println(led_current);
+  Serial.print("Average LED current, red-only reference (mA): ");
+  Serial.println(kReferenceLedCurrent);
+}
+
+void processReference(const MAX3010xRawData& raw) {
+  for(uint8_t i = 0; i < raw.samples; i++) {
+    float red = low_pass_filter_red.process(raw.value(i, kRedSlot));
+    float ir = low_pass_filter_ir.process(raw.value(i, kIrSlot));
+    stat_red.process(red);
+    stat_ir.process(ir);
+
+    // Zero crossing of the derivative
+    float diff = differentiator.process(high_pass_filter.process(red));
+    if(!isnan(diff) && !isnan(last_diff) && last_diff > 0 && diff < 0) reference_crossings++;
+    last_diff = diff;
+  }
+}
+
+void loop() {
+  sensor.drainRaw([](const MAX3010xRawData& raw) {
+    unsigned long start = micros();
+
+    float decimated[MAX3010x_I2C_BUFFER_SIZE / 9 / kDecimation + 1];
+    uint8_t n = decimator.process(raw, kGreenSlot, decimated);
+    heart_rate.process(decimated, n);
+    
+    quality_green.process(raw, kGreenSlot);
+    quality_red.process(raw, kRedSlot);
+    quality_ir.process(raw, kIrSlot);
+
+    processing_us += micros() - start;
+    processed_samples += raw.samples;
+
+    if(kTimeReference) {
+      start = micros();
+      processReference(raw);
+      reference_us += micros() - start;
+    }
+  });
+
+  if(millis() - last_output < kOutputIntervalMs) return;
+  last_output = millis();
+
+  // Finger detection and signal quality using the green channel
+  if(!quality_green.usable()) {
+    Serial.println("No finger or insufficient signal quality");
+    heart_rate.reset();
+  }
+  else {
+    if(heart_rate.estimate()) {
+      Serial.print("Heart Rate (bpm): ");
+      Serial.print(heart_rate.bpm());
+      Serial.print(", confidence: ");
+      Serial.println(heart_rate.confidence());
+    }
+
+    if(quality_red.usable() && quality_ir.usable()) {
+      float r = quality_red.perfusionIndex() / quality_ir.perfusionIndex();
+      float spo2 = kSpO2_A * r * r + kSpO2_B * r + kSpO2_C;
+      Serial.print("R-Value: ");
+      Serial.println(r);
+      Serial.print("SpO2 (%): ");
+      Serial.println(spo2);
+    }
+  }
+
+  // CPU load of the signal processing: time per sample and per second at the sampling rate of each pipeline
+  if(processed_samples > 0) {
+    float green_us = processing_us / static_cast<float>(processed_samples);
+    Serial.print("Processing time per sample (us): ");
+    Serial.print(green_us);
+    Serial.print(", per second at 100 SPS (us): ");
+    Serial.println(green_us * kSamplingFrequency);
+
+    if(kTimeReference) {
+      float red_us = reference_us / static_cast<float>(processed_samples);
+      Serial.print("Red-only reference, per sample (us): ");
+      Serial.print(red_us);
+      Serial.print(", per second at 400 SPS (us): ");
+      Serial.println(red_us * kReferenceSamplingFrequency);
+    }
+  }
+  stat_red.reset();
+  stat_ir.reset();
+  processing_us = 0;
+  reference_us = 0;
+  processed_samples = 0;
+}
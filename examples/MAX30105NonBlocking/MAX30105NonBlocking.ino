@@ -0,0 +1,46 @@
+#include <MAX3010x.h>
+
+MAX30105 sensor;
+
+// Temperature measurement interval
+const unsigned long kTemperatureIntervalMs = 5000;
+unsigned long last_temperature = 0;
+
+void setup() {
+  Serial.begin(115200);
+
+  // Use fast mode I2C if possible, FIFO draining at high sampling rates is limited by the bus
+  if(sensor.begin(sensor.BUS_CLOCK_FAST)) { 
+    Serial.print("I2C clock (Hz): ");
+    Serial.println(sensor.busClock());
+    Serial.println("Red,IR");
+  }
+  else {
+    Serial.println("Sensor not found");  
+    while(1);
+  }  
+}
+
+void loop() {
+  // Request a temperature measurement from time to time
+  if(millis() - last_temperature > kTemperatureIntervalMs) {
+    sensor.requestTemperature();
+    last_temperature = millis();
+  }
+
+  // Each call performs at most one I2C transaction and never waits, unless a transfer fails
+  auto status = sensor.poll([](const MAX3010xRawData& raw) {
+    for(int i = 0; i < raw.samples; i++) {
+      Serial.print(raw.value(i, 0));
+      Serial.print(",");
+      Serial.println(raw.value(i, 1));
+    }
+  });
+
+  if(status == sensor.POLL_TEMPERATURE) {
+    Serial.print("Temperature (C): ");
+    Serial.println(sensor.polledTemperature());
+  }
+
+  // Other tasks (radio stack, display, ...) can run here
+}
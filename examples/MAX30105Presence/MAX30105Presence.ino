@@ -0,0 +1,54 @@
+#include <MAX3010x.h>
+#include <MAX30105_presence.h>
+
+MAX30105 sensor;
+
+// Finger Detection Threshold and Cooldown
+const unsigned long kFingerThreshold = 10000;
+const unsigned int kFingerCooldownMs = 500;
+
+// Proximity Threshold (8 MSBs of the IR value) and Pilot LED Current (0.2 mA steps)
+const uint8_t kProximityThreshold = 0x14;
+const uint8_t kPilotCurrent = 0x19;
+
+MAX30105PresenceDetector presence(sensor, kFingerThreshold, kFingerCooldownMs);
+
+void setup() {
+  Serial.begin(115200);
+
+  if(sensor.begin() && presence.begin(kProximityThreshold, kPilotCurrent)) { 
+    Serial.println("Waiting for finger");
+  }
+  else {
+    Serial.println("Sensor not found");  
+    while(1);
+  }  
+}
+
+void loop() {
+  if(!presence.present()) {
+    // The sensor measures with the pilot LED only, the FIFO stays empty
+    if(presence.update()) {
+      Serial.println("Finger detected");
+    }
+    return;
+  }
+
+  auto sample = sensor.readSample(1000);
+  if(!sample.valid) return;
+
+  if(presence.process(sample.ir)) {
+    Serial.println("Finger removed");
+    Serial.print("Transition latency (ms): ");
+    Serial.println(presence.latency());
+    Serial.print("Time in proximity mode (ms): ");
+    Serial.println(presence.proximityTime());
+    Serial.print("Time in measurement mode (ms): ");
+    Serial.println(presence.measurementTime());
+    return;
+  }
+
+  Serial.print(sample.red);
+  Serial.print(",");
+  Serial.println(sample.ir);
+}
@@ -1,4 +1,5 @@
 #include <MAX3010x.h>
+#include <MAX3010x_pipeline.h>
 #include "filters.h"
 
 // Sensor (adjust to your sensor type)
@@ -34,10 +35,11 @@ void setup() {
   }
 }
 
-// Filter Instances
-HighPassFilter high_pass_filter(kHighPassCutoff, kSamplingFrequency);
-LowPassFilter low_pass_filter(kLowPassCutoff, kSamplingFrequency);
-Differentiator differentiator(kSamplingFrequency);
+// Filter Instances: Low pass, high pass and differentiator fused into one pipeline
+MAX3010xPipeline<LowPassFilter, HighPassFilter, Differentiator> pipeline(
+  LowPassFilter(kLowPassCutoff, kSamplingFrequency),
+  HighPassFilter(kHighPassCutoff, kSamplingFrequency),
+  Differentiator(kSamplingFrequency));
 MovingAverageFilter<kAveragingSamples> averager;
 
 // Timestamp of the last heartbeat
@@ -64,19 +66,15 @@ void loop() {
   }
   else {
     // Reset values if the finger is removed
-    differentiator.reset();
+    pipeline.reset();
     averager.reset();
-    low_pass_filter.reset();
-    high_pass_filter.reset();
     
     finger_detected = false;
     finger_timestamp = millis();
   }
 
   if(finger_detected) {
-    current_value = low_pass_filter.process(current_value);
-    current_value = high_pass_filter.process(current_value);
-    float current_diff = differentiator.process(current_value);
+    float current_diff = pipeline.process(current_value);
 
     // Valid values?
     if(!isnan(current_diff) && !isnan(last_diff)) {
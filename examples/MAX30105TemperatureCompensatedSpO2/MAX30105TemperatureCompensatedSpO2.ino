@@ -0,0 +1,103 @@
+#include <MAX3010x.h>
+#include <MAX3010x_signalQuality.h>
+#include <MAX3010x_spo2Calibration.h>
+
+MAX30105 sensor;
+const auto kSamplingRate = sensor.SAMPLING_RATE_100SPS;
+const float kSamplingFrequency = 100.0;
+
+// Signal quality of red and IR
+MAX3010xSignalQuality quality_red(kSamplingFrequency);
+MAX3010xSignalQuality quality_ir(kSamplingFrequency);
+
+// SpO2: AC/DC statistics of red and IR over an output interval, low-pass filtered (about 5 Hz)
+MAX3010xPulseStatistic stat_red;
+MAX3010xPulseStatistic stat_ir;
+uint32_t low_pass_red = 0;    // Filtered value times 4
+uint32_t low_pass_ir = 0;
+
+uint32_t lowPass(uint32_t& state, uint32_t value) {
+  state = state == 0 ? value << 2 : state + value - (state >> 2);
+  return state >> 2;
+}
+
+// R value to SpO2 calibration factors, tabulated at compile time
+// See https://www.maximintegrated.com/en/design/technical-documents/app-notes/6/6845.html
+struct SpO2Calibration {
+  static constexpr float a = 1.5958422;
+  static constexpr float b = -34.6596622;
+  static constexpr float c = 112.6898759;
+};
+
+// Temperature drift of R (example value, determine it for your sensor, 0 disables the compensation)
+const float kRatioDrift = 0.002;      // Relative change of R per °C
+const float kReferenceTemperature = 25.0;
+
+// R correction for the current temperature, the curve is looked up in flash
+MAX3010xSpO2Calibration<SpO2Calibration> calibration(kRatioDrift, kReferenceTemperature);
+
+// Temperature measurement interval, the measurement is interleaved with the FIFO drains
+const unsigned long kTemperatureIntervalMs = 5000;
+unsigned long last_temperature = 0;
+float temperature = NAN;
+
+// Output interval, covers at least one beat above 40 BPM
+const unsigned long kOutputIntervalMs = 1500;
+unsigned long last_output = 0;
+
+void setup() {
+  Serial.begin(115200);
+
+  if(sensor.begin() && sensor.setSamplingRate(kSamplingRate)) { 
+    Serial.println("Sensor initialized");
+  }
+  else {
+    Serial.println("Sensor not found");  
+    while(1);
+  }
+}
+
+void loop() {
+  // Request a temperature measurement from time to time
+  if(millis() - last_temperature > kTemperatureIntervalMs) {
+    sensor.requestTemperature();
+    last_temperature = millis();
+  }
+
+  // Each call performs at most one I2C transaction and never waits, unless a transfer fails
+  auto status = sensor.poll([](const MAX3010xRawData& raw) {
+    quality_red.process(raw, 0);
+    quality_ir.process(raw, 1);
+    for(uint8_t i = 0; i < raw.samples; i++) {
+      stat_red.process(lowPass(low_pass_red, raw.value(i, 0)));
+      stat_ir.process(lowPass(low_pass_ir, raw.value(i, 1)));
+    }
+  });
+
+  // Update the R correction for the new temperature
+  if(status == sensor.POLL_TEMPERATURE) {
+    temperature = sensor.polledTemperature();
+    calibration.setTemperature(temperature);
+  }
+
+  if(millis() - last_output < kOutputIntervalMs) return;
+  last_output = millis();
+
+  if(quality_red.usable() && quality_ir.usable()) {
+    // Integer path: R in Q10, SpO2 in Q8 (printed in 0.01 %)
+    Serial.print("Temperature (C): ");
+    Serial.println(temperature);
+    Serial.print("R-Value (1/1024): ");
+    Serial.println(MAX3010xRatio::q10(stat_red.ac(), stat_red.dc(), stat_ir.ac(), stat_ir.dc()));
+    Serial.print("SpO2 (uncompensated, 0.01 %): ");
+    Serial.println((MAX3010xSpO2Lookup<SpO2Calibration>::spo2(stat_red, stat_ir) * 100UL) >> 8);
+    Serial.print("SpO2 (compensated, 0.01 %): ");
+    Serial.println((calibration.spo2(stat_red, stat_ir) * 100UL) >> 8);
+  }
+  else {
+    Serial.println("No finger or insufficient signal quality");
+  }
+
+  stat_red.reset();
+  stat_ir.reset();
+}
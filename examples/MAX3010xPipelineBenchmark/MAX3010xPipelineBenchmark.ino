@@ -0,0 +1,84 @@
+#include <MAX3010x_pipeline.h>
+#include "filters.h"
+
+// Compares the processing cost of hand-chained filters with a fused pipeline (no sensor required)
+const float kSamplingFrequency = 400.0;
+const float kLowPassCutoff = 5.0;
+const float kHighPassCutoff = 0.5;
+
+// Batch size of a FIFO drain and number of batches per measurement
+const int kBatchSize = 32;
+const int kBatches = 100;
+
+// Hand-chained: one filter per object, one pass over the batch per stage
+LowPassFilter low_pass_filter(kLowPassCutoff, kSamplingFrequency);
+HighPassFilter high_pass_filter(kHighPassCutoff, kSamplingFrequency);
+Differentiator differentiator(kSamplingFrequency);
+
+// Fused: all stages in one loop
+MAX3010xPipeline<LowPassFilter, HighPassFilter, Differentiator> pipeline(
+  LowPassFilter(kLowPassCutoff, kSamplingFrequency),
+  HighPassFilter(kHighPassCutoff, kSamplingFrequency),
+  Differentiator(kSamplingFrequency));
+
+float input[kBatchSize];
+float output[kBatchSize];
+
+// Synthetic PPG: 1.2 Hz pulse on a DC level
+void generate(int batch) {
+  for(int i = 0; i < kBatchSize; i++) {
+    float t = (batch * kBatchSize + i) / kSamplingFrequency;
+    input[i] = 50000.0 + 500.0 * sin(2 * PI * 1.2 * t);
+  }
+}
+
+float checksum() {
+  float sum = 0;
+  for(int i = 0; i < kBatchSize; i++) {
+    if(!isnan(output[i])) sum += output[i];
+  }
+  return sum;
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  // Hand-chained, stage by stage
+  float chained_sum = 0;
+  unsigned long chained_us = 0;
+  for(int b = 0; b < kBatches; b++) {
+    generate(b);
+    unsigned long start = micros();
+    for(int i = 0; i < kBatchSize; i++) output[i] = low_pass_filter.process(input[i]);
+    for(int i = 0; i < kBatchSize; i++) output[i] = high_pass_filter.process(output[i]);
+    for(int i = 0; i < kBatchSize; i++) output[i] = differentiator.process(output[i]);
+    chained_us += micros() - start;
+    chained_sum += checksum();
+  }
+
+  // Fused pipeline
+  float fused_sum = 0;
+  unsigned long fused_us = 0;
+  for(int b = 0; b < kBatches; b++) {
+    generate(b);
+    unsigned long start = micros();
+    pipeline.process(input, output, kBatchSize);
+    fused_us += micros() - start;
+    fused_sum += checksum();
+  }
+
+  const float samples = kBatches * kBatchSize;
+  Serial.print("Hand-chained (us per sample): ");
+  Serial.println(chained_us / samples);
+  Serial.print("Fused pipeline (us per sample): ");
+  Serial.println(fused_us / samples);
+
+  // Both variants have to produce the same output
+  Serial.print("Checksums: ");
+  Serial.print(chained_sum);
+  Serial.print(", ");
+  Serial.println(fused_sum);
+}
+
+void loop() {
+}
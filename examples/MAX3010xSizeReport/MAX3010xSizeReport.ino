@@ -0,0 +1,67 @@
+#include <MAX3010x.h>
+
+// Size report: flash and RAM of the driver per supported chip combination (no sensor required)
+// Select the sensors the firmware supports and compare the sketch size reported by the IDE, e.g.
+//   arduino-cli compile -b arduino:avr:uno examples/MAX3010xSizeReport
+//   arduino-cli compile -b arduino:avr:uno --build-property "compiler.cpp.extra_flags=-DSIZE_REPORT_MAX30101=1 -DSIZE_REPORT_MAX30105=1" examples/MAX3010xSizeReport
+// With all sensors disabled the sketch reports the size of the platform code only.
+// extras/linux/sizeReport.sh builds every combination and prints a flash/RAM table,
+// extras/linux/sizeReport_host.txt is the baseline of the host build.
+#ifndef SIZE_REPORT_MAX30100
+#define SIZE_REPORT_MAX30100 0
+#endif
+#ifndef SIZE_REPORT_MAX30101
+#define SIZE_REPORT_MAX30101 0
+#endif
+#ifndef SIZE_REPORT_MAX30102
+#define SIZE_REPORT_MAX30102 0
+#endif
+#ifndef SIZE_REPORT_MAX30105
+#define SIZE_REPORT_MAX30105 1
+#endif
+
+volatile uint32_t sink;
+
+// Typical use of a sensor: blocking and non-blocking reads, configuration and temperature
+template<class Sensor> void use(Sensor& sensor) {
+  if(!sensor.begin()) return;
+  sensor.setSamplingRate(sensor.SAMPLING_RATE_100SPS);
+  sink = sensor.readSample(100).valid;
+  sink = sensor.readTemperature();
+  sensor.poll([](const MAX3010xRawData& raw) {
+    sink = raw.value(0, 0);
+  });
+}
+
+#if SIZE_REPORT_MAX30100
+MAX30100 sensor30100;
+#endif
+#if SIZE_REPORT_MAX30101
+MAX30101 sensor30101;
+#endif
+#if SIZE_REPORT_MAX30102
+MAX30102 sensor30102;
+#endif
+#if SIZE_REPORT_MAX30105
+MAX30105 sensor30105;
+#endif
+
+void setup() {
+  Serial.begin(115200);
+}
+
+void loop() {
+#if SIZE_REPORT_MAX30100
+  use(sensor30100);
+#endif
+#if SIZE_REPORT_MAX30101
+  use(sensor30101);
+#endif
+#if SIZE_REPORT_MAX30102
+  use(sensor30102);
+#endif
+#if SIZE_REPORT_MAX30105
+  use(sensor30105);
+#endif
+  delay(1000);
+}
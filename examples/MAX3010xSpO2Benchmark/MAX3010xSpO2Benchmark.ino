@@ -0,0 +1,93 @@
+#include <MAX3010x_spo2Fixed.h>
+
+// Compares the float SpO2 calculation of the examples with the integer lookup (no sensor required)
+// Set to 0 to build the integer path only and compare the sketch size reported by the IDE
+#define SPO2_BENCHMARK_FLOAT 1
+
+const int kIterations = 1000;
+
+// R value to SpO2 calibration factors (same as MAX3010xMaximSpO2Calibration)
+float kSpO2_A = 1.5958422;
+float kSpO2_B = -34.6596622;
+float kSpO2_C = 112.6898759;
+
+// Beat statistics: DC level and pulsatile component of red and IR
+struct Beat {
+  uint32_t acRed, dcRed, acIr, dcIr;
+};
+
+// Deterministic pseudo random beats (R between 0.4 and 1.4)
+uint32_t seed = 1;
+uint32_t next(uint32_t range) {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 8) % range;
+}
+
+Beat generate() {
+  Beat beat;
+  beat.dcIr = 50000 + next(150000);
+  beat.dcRed = beat.dcIr / 2 + next(beat.dcIr);
+  beat.acIr = beat.dcIr / 100 + next(beat.dcIr / 50);
+  uint32_t r = 400 + next(1000);    // R in 1/1000
+  beat.acRed = static_cast<uint64_t>(beat.acIr) * beat.dcRed / beat.dcIr * r / 1000;
+  return beat;
+}
+
+// Prints the total time and the time per calculation in integers, so no float printing code is linked
+void printTime(const char* name, unsigned long total_us) {
+  Serial.print(name);
+  Serial.print(" (us for ");
+  Serial.print(kIterations);
+  Serial.print(" calculations): ");
+  Serial.print(total_us);
+  Serial.print(", ns per calculation: ");
+  Serial.println(total_us * 1000 / kIterations);
+}
+
+volatile uint16_t sink_int;
+#if SPO2_BENCHMARK_FLOAT
+volatile float sink_float;
+#endif
+
+void setup() {
+  Serial.begin(115200);
+
+  // Integer path: one 32 bit division and a table interpolation
+  seed = 1;
+  unsigned long int_us = 0;
+  for(int i = 0; i < kIterations; i++) {
+    Beat beat = generate();
+    unsigned long start = micros();
+    sink_int = MAX3010xSpO2Lookup<>::spo2(MAX3010xRatio::q10(beat.acRed, beat.dcRed, beat.acIr, beat.dcIr));
+    int_us += micros() - start;
+  }
+  printTime("Integer", int_us);
+
+#if SPO2_BENCHMARK_FLOAT
+  // Float path of the examples: three divisions and the quadratic
+  seed = 1;
+  unsigned long float_us = 0;
+  float max_error = 0;
+  for(int i = 0; i < kIterations; i++) {
+    Beat beat = generate();
+    unsigned long start = micros();
+    float rred = static_cast<float>(beat.acRed) / beat.dcRed;
+    float rir = static_cast<float>(beat.acIr) / beat.dcIr;
+    float r = rred / rir;
+    float spo2 = kSpO2_A * r * r + kSpO2_B * r + kSpO2_C;
+    sink_float = spo2;
+    float_us += micros() - start;
+
+    // Deviation of the integer result (the lookup is limited to 0 - 100 %)
+    float fixed = MAX3010xSpO2Lookup<>::spo2(MAX3010xRatio::q10(beat.acRed, beat.dcRed, beat.acIr, beat.dcIr)) / 256.0;
+    float error = fabs(fixed - min(spo2, 100.0f));
+    if(error > max_error) max_error = error;
+  }
+  printTime("Float", float_us);
+  Serial.print("Maximum deviation (% SpO2): ");
+  Serial.println(max_error, 3);
+#endif
+}
+
+void loop() {
+}
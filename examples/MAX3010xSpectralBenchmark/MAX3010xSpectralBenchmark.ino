@@ -0,0 +1,63 @@
+#include <MAX3010x_spectralHeartRate.h>
+
+// CPU cost of the spectral heart rate estimator per sample and per estimate (no sensor required)
+// The load is given for the input rate and one estimate per second.
+const int kSamples = 2000;
+const int kEstimates = 100;
+const float kHeartRate = 72.0;    // BPM of the synthetic pulse
+
+// Configuration of the green pulse oximeter example: 12.5 Hz, 10.24 s window (34 bins)
+MAX3010xSpectralHeartRate<128, 36> heart_rate_short(12.5);
+// 25 Hz, 10.24 s window (35 bins)
+MAX3010xSpectralHeartRate<256, 48> heart_rate_long(25.0);
+
+volatile float sink;
+
+// Synthetic PPG: pulse with its first harmonic on a DC level
+float generate(long i, float rate) {
+  float t = i / rate;
+  return 50000.0 + 500.0 * sin(2 * PI * kHeartRate / 60.0 * t) + 150.0 * sin(4 * PI * kHeartRate / 60.0 * t);
+}
+
+template<class Estimator> void benchmark(const char* name, Estimator& estimator, float rate) {
+  unsigned long process_us = 0;
+  for(long i = 0; i < kSamples; i++) {
+    float value = generate(i, rate);
+    unsigned long start = micros();
+    estimator.process(value);
+    process_us += micros() - start;
+  }
+
+  unsigned long estimate_us = 0;
+  for(int i = 0; i < kEstimates; i++) {
+    unsigned long start = micros();
+    estimator.estimate();
+    estimate_us += micros() - start;
+  }
+  sink = estimator.bpm();
+
+  float us_per_sample = process_us / static_cast<float>(kSamples);
+  float us_per_estimate = estimate_us / static_cast<float>(kEstimates);
+
+  Serial.println(name);
+  Serial.print("  Process (us per sample): ");
+  Serial.println(us_per_sample, 2);
+  Serial.print("  Estimate (us): ");
+  Serial.println(us_per_estimate, 1);
+  Serial.print("  CPU load (%): ");
+  Serial.println((us_per_sample * rate + us_per_estimate) / 1e4, 3);
+  Serial.print("  Heart rate (BPM): ");
+  Serial.print(estimator.bpm(), 1);
+  Serial.print(", confidence: ");
+  Serial.println(estimator.confidence(), 2);
+}
+
+void setup() {
+  Serial.begin(115200);
+
+  benchmark("Window 128 at 12.5 Hz", heart_rate_short, 12.5);
+  benchmark("Window 256 at 25 Hz", heart_rate_long, 25.0);
+}
+
+void loop() {
+}
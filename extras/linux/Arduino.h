@@ -0,0 +1,60 @@
+/*!
+ * @file Arduino.h
+ *
+ * Minimal Arduino API for building the sensor drivers on Linux hosts.
+ * Only the functions used by the library are provided, timing is based on std::chrono::steady_clock.
+ */
+
+
+#ifndef _MAX3010x_LINUX_ARDUINO_H
+#define _MAX3010x_LINUX_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include <chrono>
+#include <thread>
+
+typedef uint8_t byte;
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+/**
+ * Time since the first call
+ * @return Time in us
+ */
+inline unsigned long micros() {
+  static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+/**
+ * Time since the first call
+ * @return Time in ms
+ */
+inline unsigned long millis() {
+  return micros() / 1000;
+}
+
+inline void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+inline void delayMicroseconds(unsigned int us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+// GPIO is not available, bus clears are handled by the kernel driver
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return HIGH; }
+
+#endif
@@ -0,0 +1,395 @@
+/*!
+ * @file MAX3010x_ingestion.h
+ */
+
+
+#ifndef _MAX3010x_INGESTION_H
+#define _MAX3010x_INGESTION_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "MAX3010x_core.h"
+
+/**
+ * Lock-Free Single Producer Single Consumer Queue
+ *
+ * Items are written and read in place (reserve()/commit(), front()/pop()), so large batches
+ * are not copied through the queue.
+ *
+ * @tparam T Item type
+ * @tparam kSize Capacity (power of two)
+ */
+template<class T, uint16_t kSize> class MAX3010xSpscQueue {
+  static_assert(kSize > 0 && (kSize & (kSize - 1)) == 0, "Queue size must be a power of two");
+
+  T _items[kSize];                          //!< Ring buffer
+  std::atomic<uint32_t> _head;              //!< Index of the oldest item (written by the consumer)
+  uint8_t _padding[64];                     //!< Keeps head and tail in separate cache lines
+  std::atomic<uint32_t> _tail;              //!< Index of the next free item (written by the producer)
+public:
+  MAX3010xSpscQueue() : _head(0), _tail(0) {}
+
+  /**
+   * Next free item (producer)
+   * @return Item or nullptr if the queue is full
+   */
+  T* reserve() {
+    const uint32_t tail = _tail.load(std::memory_order_relaxed);
+    if(tail - _head.load(std::memory_order_acquire) == kSize) return nullptr;
+    return &_items[tail & (kSize - 1)];
+  }
+
+  /**
+   * Publish the reserved item (producer)
+   */
+  void commit() {
+    _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  /**
+   * Oldest item (consumer)
+   * @return Item or nullptr if the queue is empty
+   */
+  T* front() {
+    const uint32_t head = _head.load(std::memory_order_relaxed);
+    if(head == _tail.load(std::memory_order_acquire)) return nullptr;
+    return &_items[head & (kSize - 1)];
+  }
+
+  /**
+   * Release the oldest item (consumer)
+   */
+  void pop() {
+    _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  /**
+   * Number of queued items
+   * @return Number of items
+   */
+  uint32_t size() const {
+    return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+  }
+};
+
+/**
+ * Ingestion Statistics of a Sensor
+ */
+struct MAX3010xIngestionStats {
+  static const uint8_t LATENCY_BINS = 12;   //!< Number of latency bins, bin i counts latencies below 128 us << i (last bin: all above)
+
+  uint64_t drains;              //!< Batches drained by the bus thread
+  uint64_t batches;             //!< Batches processed by the workers
+  uint64_t samples;             //!< Samples processed by the workers
+  uint64_t backpressure;        //!< Drains skipped because the queue was full
+  uint32_t samplesLost;         //!< Samples lost due to FIFO overflows or dropped because a drain exceeded the batch
+  uint32_t queued;              //!< Batches waiting in the queue
+  uint32_t minLatency;          //!< Minimum latency from drain to processed in us
+  uint32_t maxLatency;          //!< Maximum latency from drain to processed in us
+  uint32_t meanLatency;         //!< Mean latency from drain to processed in us
+  uint64_t latency[LATENCY_BINS]; //!< Latency histogram
+};
+
+/**
+ * Multi-Threaded Sensor Ingestion (Linux)
+ *
+ * Reads many sensors on several I2C buses. Each bus is served by its own reader thread, so a slow
+ * or failing bus only delays the sensors on that bus. The reader drains the FIFO of each sensor in
+ * bursts (drainRaw()) directly into a lock-free single producer single consumer queue per sensor.
+ * A pool of worker threads runs the signal processing. Each sensor is assigned to one worker, so
+ * the processor of a sensor is never called concurrently and needs no locking.
+ *
+ * Backpressure: If the queue of a sensor is full, its drain is skipped and the samples remain in
+ * the sensor FIFO. Only if the workers fall behind for longer than the FIFO can buffer, samples
+ * are lost (counted in MAX3010xIngestionStats::samplesLost).
+ *
+ * The sensors have to be configured and must not be accessed by the application while the ingestion is running.
+ *
+ * Usage:
+ * @code
+ * MAX3010xLinuxTransport bus1(1);
+ * MAX30105 sensor(MAX3010x_ADDR, bus1);
+ * MAX3010xIngestion<> ingestion;
+ * uint8_t bus = ingestion.addBus();
+ * ingestion.addSensor(bus, sensor, [&](const MAX3010xRawData& raw) { ... });
+ * ingestion.start(4);
+ * @endcode
+ *
+ * Build (from extras/linux):
+ * g++ -std=c++11 -O2 -pthread -I. -I../../src -DMAX3010x_I2C_BUFFER_SIZE=192 app.cpp ../../src/MAX30105.cpp ../../src/MAX3010x_core.cpp
+ *
+ * @tparam kQueueSize Number of batches queued per sensor (power of two)
+ */
+template<uint16_t kQueueSize = 16> class MAX3010xIngestion {
+public:
+  /**
+   * Processing Function
+   * @param raw Drained samples of one sensor
+   */
+  typedef std::function<void(const MAX3010xRawData& raw)> Processor;
+
+private:
+  /**
+   * Drained Batch
+   */
+  struct Batch {
+    static const uint16_t kMaxBytes = 32 * 4 * 3;   //!< Full FIFO with four slots of three bytes
+
+    uint8_t data[kMaxBytes];    //!< Raw FIFO bytes
+    MAX3010xRawData raw;        //!< Span over data
+    uint64_t drainMicros;       //!< Time of the drain completion in us
+  };
+
+  /**
+   * Per-Sensor State
+   */
+  struct Channel {
+    void* sensor;                                     //!< Sensor instance
+    uint8_t (*drain)(Channel& channel, Batch& batch); //!< Drain function for the sensor type
+    Processor processor;                              //!< Processing function
+    MAX3010xSpscQueue<Batch, kQueueSize> queue;       //!< Drained batches
+
+    // Written by the bus thread
+    std::atomic<uint64_t> drains;
+    std::atomic<uint64_t> backpressure;
+    std::atomic<uint32_t> samplesLost;
+    uint32_t samplesDropped;                          //!< Samples that did not fit into a batch
+
+    // Written by the worker
+    std::atomic<uint64_t> batches;
+    std::atomic<uint64_t> samples;
+    std::atomic<uint64_t> latencySum;
+    std::atomic<uint32_t> minLatency;
+    std::atomic<uint32_t> maxLatency;
+    std::atomic<uint64_t> latency[MAX3010xIngestionStats::LATENCY_BINS];
+
+    Channel() : sensor(nullptr), drain(nullptr), drains(0), backpressure(0), samplesLost(0), samplesDropped(0),
+                batches(0), samples(0), latencySum(0), minLatency(UINT32_MAX), maxLatency(0) {
+      for(uint8_t i = 0; i < MAX3010xIngestionStats::LATENCY_BINS; i++) latency[i] = 0;
+    }
+  };
+
+  /**
+   * Bus with its reader thread
+   */
+  struct Bus {
+    std::vector<Channel*> channels;   //!< Sensors on the bus
+    std::thread thread;               //!< Reader thread
+  };
+
+  std::vector<std::unique_ptr<Channel>> _channels;  //!< Sensors
+  std::vector<std::unique_ptr<Bus>> _buses;         //!< Buses
+  std::vector<std::thread> _workers;                //!< Worker threads
+  std::atomic<bool> _running;                       //!< Threads running
+  unsigned int _idleMicros;                         //!< Sleep time of idle threads in us
+
+  /**
+   * Time since the start of the process
+   * @return Time in us
+   */
+  static uint64_t now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  /**
+   * Drain a sensor into a batch
+   * @tparam Sensor Sensor type
+   * @param channel Channel
+   * @param batch Batch
+   * @return Number of samples
+   */
+  template<class Sensor> static uint8_t drainSensor(Channel& channel, Batch& batch) {
+    Sensor& sensor = *static_cast<Sensor*>(channel.sensor);
+    uint16_t bytes = 0;
+
+    batch.raw.data = batch.data;
+    batch.raw.samples = 0;
+    sensor.drainRaw([&](const MAX3010xRawData& raw) {
+      const uint16_t length = raw.samples * raw.slots * raw.sampleSize;
+      if(bytes + length > Batch::kMaxBytes) {
+        channel.samplesDropped += raw.samples;
+        return;
+      }
+
+      memcpy(batch.data + bytes, raw.data, length);
+      bytes += length;
+      batch.raw.samples += raw.samples;
+      batch.raw.slots = raw.slots;
+      batch.raw.sampleSize = raw.sampleSize;
+      batch.raw.resolution = raw.resolution;
+    });
+
+    channel.samplesLost.store(sensor.samplesLost() + channel.samplesDropped, std::memory_order_relaxed);
+    return batch.raw.samples;
+  }
+
+  /**
+   * Reader thread of a bus
+   * @param bus Bus
+   */
+  void readBus(Bus& bus) {
+    while(_running.load(std::memory_order_relaxed)) {
+      bool drained = false;
+      for(Channel* channel : bus.channels) {
+        Batch* batch = channel->queue.reserve();
+        if(!batch) {
+          channel->backpressure.fetch_add(1, std::memory_order_relaxed);
+          continue;
+        }
+
+        if(channel->drain(*channel, *batch) > 0) {
+          batch->drainMicros = now();
+          channel->queue.commit();
+          channel->drains.fetch_add(1, std::memory_order_relaxed);
+          drained = true;
+        }
+      }
+
+      if(!drained) std::this_thread::sleep_for(std::chrono::microseconds(_idleMicros));
+    }
+  }
+
+  /**
+   * Worker thread
+   * @param worker Worker index
+   * @param workers Number of workers
+   */
+  void work(unsigned int worker, unsigned int workers) {
+    while(_running.load(std::memory_order_relaxed)) {
+      bool processed = false;
+      for(size_t i = worker; i < _channels.size(); i += workers) {
+        Channel& channel = *_channels[i];
+        while(Batch* batch = channel.queue.front()) {
+          channel.processor(batch->raw);
+
+          const uint32_t latency = static_cast<uint32_t>(now() - batch->drainMicros);
+          channel.batches.fetch_add(1, std::memory_order_relaxed);
+          channel.samples.fetch_add(batch->raw.samples, std::memory_order_relaxed);
+          channel.latencySum.fetch_add(latency, std::memory_order_relaxed);
+          if(latency < channel.minLatency.load(std::memory_order_relaxed)) channel.minLatency.store(latency, std::memory_order_relaxed);
+          if(latency > channel.maxLatency.load(std::memory_order_relaxed)) channel.maxLatency.store(latency, std::memory_order_relaxed);
+          channel.latency[MAX3010xDiagnostics::latencyBin(latency, MAX3010xIngestionStats::LATENCY_BINS)].fetch_add(1, std::memory_order_relaxed);
+
+          channel.queue.pop();
+          processed = true;
+        }
+      }
+
+      if(!processed) std::this_thread::sleep_for(std::chrono::microseconds(_idleMicros));
+    }
+  }
+public:
+  /**
+   * Constructor
+   * @param idleMicros Sleep time of reader and worker threads without data in us
+   */
+  MAX3010xIngestion(unsigned int idleMicros = 500) : _running(false), _idleMicros(idleMicros) {}
+
+  ~MAX3010xIngestion() {
+    stop();
+  }
+
+  /**
+   * Add a bus
+   * @return Bus index
+   */
+  uint8_t addBus() {
+    _buses.emplace_back(new Bus());
+    return _buses.size() - 1;
+  }
+
+  /**
+   * Add a sensor
+   * @remarks The sensor needs to be configured and has to use the transport of the bus.
+   * @param bus Bus index
+   * @param sensor Sensor instance
+   * @param processor Processing function, called by a worker thread for every drained batch
+   * @return Sensor index or -1 on failure
+   */
+  template<class Sensor> int addSensor(uint8_t bus, Sensor& sensor, Processor processor) {
+    if(_running || bus >= _buses.size()) return -1;
+
+    Channel* channel = new Channel();
+    channel->sensor = &sensor;
+    channel->drain = &drainSensor<Sensor>;
+    channel->processor = processor;
+    _channels.emplace_back(channel);
+    _buses[bus]->channels.push_back(channel);
+    return _channels.size() - 1;
+  }
+
+  /**
+   * Start the reader and worker threads
+   * @param workers Number of worker threads (0: number of cores)
+   * @return true if successful, otherwise false
+   */
+  bool start(unsigned int workers = 0) {
+    if(_running) return false;
+    if(workers == 0) workers = std::thread::hardware_concurrency();
+    if(workers == 0) workers = 1;
+
+    _running = true;
+    for(auto& bus : _buses) {
+      Bus* b = bus.get();
+      b->thread = std::thread([this, b]() { readBus(*b); });
+    }
+    for(unsigned int i = 0; i < workers; i++) {
+      _workers.emplace_back([this, i, workers]() { work(i, workers); });
+    }
+    return true;
+  }
+
+  /**
+   * Stop all threads
+   * @remarks Batches still queued are kept and processed after the ingestion is started again.
+   */
+  void stop() {
+    if(!_running) return;
+
+    _running = false;
+    for(auto& bus : _buses) bus->thread.join();
+    for(auto& worker : _workers) worker.join();
+    _workers.clear();
+  }
+
+  /**
+   * Number of sensors
+   * @return Number of sensors
+   */
+  size_t sensors() const {
+    return _channels.size();
+  }
+
+  /**
+   * Statistics of a sensor
+   * @remarks Can be called while the ingestion is running, the counters are read individually.
+   * @param sensor Sensor index
+   * @return Statistics
+   */
+  MAX3010xIngestionStats stats(size_t sensor) const {
+    const Channel& channel = *_channels[sensor];
+    MAX3010xIngestionStats stats;
+    stats.drains = channel.drains.load(std::memory_order_relaxed);
+    stats.batches = channel.batches.load(std::memory_order_relaxed);
+    stats.samples = channel.samples.load(std::memory_order_relaxed);
+    stats.backpressure = channel.backpressure.load(std::memory_order_relaxed);
+    stats.samplesLost = channel.samplesLost.load(std::memory_order_relaxed);
+    stats.queued = channel.queue.size();
+    stats.minLatency = stats.batches > 0 ? channel.minLatency.load(std::memory_order_relaxed) : 0;
+    stats.maxLatency = channel.maxLatency.load(std::memory_order_relaxed);
+    stats.meanLatency = stats.batches > 0 ? channel.latencySum.load(std::memory_order_relaxed) / stats.batches : 0;
+    for(uint8_t i = 0; i < MAX3010xIngestionStats::LATENCY_BINS; i++) {
+      stats.latency[i] = channel.latency[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+  }
+};
+
+#endif
@@ -0,0 +1,130 @@
+/*!
+ * @file MAX3010x_linuxTransport.h
+ */
+
+
+#ifndef _MAX3010x_LINUX_TRANSPORT_H
+#define _MAX3010x_LINUX_TRANSPORT_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+#include "MAX3010x_transport.h"
+
+/**
+ * Transport using the Linux I2C device interface (/dev/i2c-N)
+ *
+ * Register reads are issued as a single combined transfer (I2C_RDWR), so a FIFO burst is one
+ * kernel call. Build with -DMAX3010x_I2C_BUFFER_SIZE=192 to drain a full two slot FIFO per burst.
+ * Each bus must only be used by one thread at a time (see MAX3010xIngestion).
+ */
+class MAX3010xLinuxTransport : public MAX3010xTransport {
+  int _bus;   //!< Bus number
+  int _fd;    //!< File descriptor of the bus device (-1 if closed)
+
+  /**
+   * Map errno of a failed transfer to a bus error
+   * @param error errno
+   * @return Error
+   */
+  static uint8_t transferError(int error) {
+    switch(error) {
+      case ENXIO: return ERROR_ADDRESS_NACK;
+      case EREMOTEIO: return ERROR_DATA_NACK;
+      case ETIMEDOUT: return ERROR_TIMEOUT;
+      default: return ERROR_OTHER;
+    }
+  }
+public:
+  /**
+   * Constructor
+   * @param bus Bus number (N of /dev/i2c-N)
+   */
+  MAX3010xLinuxTransport(int bus) : _bus(bus), _fd(-1) {}
+
+  ~MAX3010xLinuxTransport() {
+    if(_fd >= 0) close(_fd);
+  }
+
+  /**
+   * Opens the bus device
+   */
+  void begin() override {
+    if(_fd >= 0) return;
+
+    char path[20];
+    snprintf(path, sizeof(path), "/dev/i2c-%d", _bus);
+    _fd = open(path, O_RDWR);
+  }
+
+  /**
+   * Read Block
+   * @param addr I2C Device Address
+   * @param reg Register
+   * @param count Number of bytes to read
+   * @param buffer Buffer for values
+   * @return true if successful, otherwise false
+   */
+  bool read(uint8_t addr, uint8_t reg, uint8_t count, uint8_t* buffer) override {
+    struct i2c_msg msgs[2];
+    msgs[0].addr = addr;
+    msgs[0].flags = 0;
+    msgs[0].len = 1;
+    msgs[0].buf = &reg;
+    msgs[1].addr = addr;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len = count;
+    msgs[1].buf = buffer;
+
+    struct i2c_rdwr_ioctl_data transfer = { msgs, 2 };
+    if(_fd < 0 || ioctl(_fd, I2C_RDWR, &transfer) != 2) {
+      _lastError = _fd < 0 ? ERROR_OTHER : transferError(errno);
+      return false;
+    }
+
+    _lastError = ERROR_NONE;
+    return true;
+  }
+
+  /**
+   * Write Block
+   * @param addr I2C Device Address
+   * @param reg Register
+   * @param count Number of bytes to write
+   * @param buffer Buffer with values
+   * @return true if successful, otherwise false
+   */
+  bool write(uint8_t addr, uint8_t reg, uint8_t count, const uint8_t* buffer) override {
+    uint8_t data[MAX3010x_I2C_BUFFER_SIZE + 1];
+    if(count > MAX3010x_I2C_BUFFER_SIZE) {
+      _lastError = ERROR_OTHER;
+      return false;
+    }
+
+    data[0] = reg;
+    memcpy(data + 1, buffer, count);
+
+    struct i2c_msg msg;
+    msg.addr = addr;
+    msg.flags = 0;
+    msg.len = count + 1;
+    msg.buf = data;
+
+    struct i2c_rdwr_ioctl_data transfer = { &msg, 1 };
+    if(_fd < 0 || ioctl(_fd, I2C_RDWR, &transfer) != 1) {
+      _lastError = _fd < 0 ? ERROR_OTHER : transferError(errno);
+      return false;
+    }
+
+    _lastError = ERROR_NONE;
+    return true;
+  }
+};
+
+#endif
@@ -0,0 +1,408 @@
+/*!
+ * @file MAX3010x_simulatedBus.h
+ *
+ * Simulated MAX30105 sensors and I2C buses for host benchmarks and tests.
+ */
+
+
+#ifndef _MAX3010x_SIMULATED_BUS_H
+#define _MAX3010x_SIMULATED_BUS_H
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "MAX3010x_transport.h"
+
+/**
+ * Simulated MAX30105
+ *
+ * Register model of the FIFO, mode and temperature registers. Samples are produced in real time
+ * according to the configured sampling rate, mode and sample averaging, the FIFO overflows like the sensor's.
+ * Slot values follow value(), so consumers can verify the received data.
+ * A new sensor starts like after powerUp(): the power ready flag is set until the status register is read.
+ * A software reset restores the register defaults without setting the flag.
+ */
+class MAX3010xSimulatedSensor {
+  static constexpr double kRates[8] = {50, 100, 200, 400, 800, 1000, 1600, 3200};
+
+  uint8_t _regs[256];       //!< Registers
+  double _start;            //!< Time the sample counted by _base was produced in us
+  uint64_t _base;           //!< Samples produced before the last configuration change
+  uint64_t _produced;       //!< Samples produced
+  uint64_t _consumed;       //!< Samples read (or discarded)
+  uint8_t _overflow;        //!< Overflow counter
+  uint8_t _byte;            //!< Byte within the current FIFO sample
+  double _oscillatorError;  //!< Relative error of the sensor's oscillator
+
+  static uint64_t now() {
+    return micros();
+  }
+
+  double period() const {
+    const uint8_t averaging = 1 << ((_regs[0x08] >> 5) > 5 ? 5 : _regs[0x08] >> 5);
+    return 1e6 / (kRates[(_regs[0x0A] >> 2) & 7] * (1 + _oscillatorError)) * averaging;
+  }
+
+  uint8_t slots() const {
+    switch(_regs[0x09] & 7) {
+      case 2: return 1;
+      case 3: return 2;
+      case 7: {
+        uint8_t n = 0;
+        for(uint8_t i = 0; i < 4; i++) {
+          uint8_t slot = (_regs[0x11 + i / 2] >> (i % 2 * 4)) & 7;
+          if(slot != 0 && slot != 4) n++;
+        }
+        return n;
+      }
+      default: return 0;
+    }
+  }
+
+  void update() {
+    if(slots() == 0 || (_regs[0x09] & 0x80)) return;
+    _produced = _base + static_cast<uint64_t>((now() - _start) / period());
+    if(_produced - _consumed > 32) {
+      const uint64_t lost = _produced - _consumed - 32;
+      _overflow = _overflow + lost > 31 ? 31 : _overflow + lost;
+      _consumed = _produced - 32;
+    }
+  }
+
+  // Restart counting at the last produced sample, the oscillator phase is kept
+  void rebase() {
+    update();
+    if(slots() == 0 || (_regs[0x09] & 0x80)) _start = now();
+    else _start += (_produced - _base) * period();
+    _base = _produced;
+  }
+public:
+  MAX3010xSimulatedSensor() : _oscillatorError(0) {
+    powerUp();
+  }
+
+  /**
+   * Slot value of a sample
+   * @param index Sample index since the last reset (including lost samples)
+   * @param slot Slot index
+   * @return Value (synthetic PPG: 1.2 Hz pulse on a DC level at 400 SPS)
+   */
+  static uint32_t value(uint64_t index, uint8_t slot) {
+    return 100000 + slot * 1000 + static_cast<int32_t>(2000 * sin(2 * PI * 1.2 * (index % 1000) / 400.0));
+  }
+
+  /**
+   * Set the oscillator error
+   * @param error Relative error (e.g. 0.01: samples are produced 1 % faster than configured)
+   */
+  void setOscillatorError(double error) {
+    rebase();
+    _oscillatorError = error;
+  }
+
+  /**
+   * Fractional index of the sample produced at a time
+   * @remarks Valid for times after the last configuration change
+   * @param time Time in us (micros())
+   * @return Sample index since the last reset (sample n is produced at index n)
+   */
+  double indexAt(double time) const {
+    return _base + (time - _start) / period() - 1;
+  }
+
+  /**
+   * Samples produced since the last reset (including lost samples)
+   * @return Number of samples
+   */
+  uint64_t produced() {
+    update();
+    return _produced;
+  }
+
+  /**
+   * Index of the next sample read from the FIFO
+   * @return Sample index since the last reset
+   */
+  uint64_t consumed() {
+    update();
+    return _consumed;
+  }
+
+  /**
+   * Power cycle: register defaults and the power ready flag (PWR_RDY) set
+   */
+  void powerUp() {
+    reset();
+    _regs[0x00] = 0x01;
+  }
+
+  void reset() {
+    memset(_regs, 0, sizeof(_regs));
+    _regs[0xFE] = 0x01;
+    _regs[0xFF] = 0x15;
+    _start = now();
+    _base = _produced = _consumed = 0;
+    _overflow = 0;
+    _byte = 0;
+  }
+
+  void write(uint8_t reg, uint8_t value) {
+    if(reg == 0x09 && (value & 0x40)) {
+      reset();
+      return;
+    }
+
+    update();
+    switch(reg) {
+      case 0x04:
+        rebase();
+        _produced = (_produced & ~31ull) | (value & 31);
+        if(_consumed > _produced) _consumed = _produced;
+        _base = _produced;
+        break;
+      case 0x05: _overflow = value & 31; break;
+      case 0x06: _consumed = _produced - ((_produced - value) & 31); break;
+      case 0x07: break;
+      case 0x21:
+        _regs[0x1F] = 30;
+        _regs[0x20] = 0;
+        _regs[0x01] |= 0x02;
+        break;
+      default:
+        if(reg == 0x08 || reg == 0x09 || reg == 0x0A) rebase();
+        _regs[reg] = value;
+        break;
+    }
+  }
+
+  uint8_t read(uint8_t reg) {
+    update();
+    switch(reg) {
+      case 0x04: return _produced & 31;
+      case 0x05: return _overflow;
+      case 0x06: return _consumed & 31;
+      case 0x07: {
+        const uint8_t byte = value(_consumed, _byte / 3) >> ((2 - _byte % 3) * 8);
+        if(++_byte >= slots() * 3) {
+          _byte = 0;
+          if(_consumed < _produced) _consumed++;
+          _overflow = 0;
+        }
+        return byte;
+      }
+      case 0x00:
+      case 0x01: {
+        const uint8_t value = _regs[reg];
+        _regs[reg] = 0;
+        return value;
+      }
+      default: return _regs[reg];
+    }
+  }
+};
+
+constexpr double MAX3010xSimulatedSensor::kRates[8];
+
+/**
+ * Simulated I2C Bus
+ *
+ * Every address holds a MAX3010xSimulatedSensor. Transfers block for the time they take at the configured clock.
+ * Faults can be injected: failing transfers and a stuck bus that is released by recoverBus().
+ */
+class MAX3010xSimulatedBus : public MAX3010xTransport {
+  MAX3010xSimulatedSensor _sensors[128];
+  uint32_t _clock;
+  std::mutex _mutex;    //!< One transfer at a time
+  uint16_t _failures;   //!< Number of transfers left to fail
+  bool _stuck;          //!< SDA held low, all transfers fail
+  bool _clearable;      //!< A bus clear releases a stuck bus
+  bool _busClear;       //!< Bus clears supported
+  uint32_t _busClears;  //!< Number of bus clears
+  uint32_t _transfers;  //!< Number of transfers (including failed ones)
+
+  void occupy(uint16_t bytes) {
+    std::this_thread::sleep_for(std::chrono::microseconds(1000000ull * 9 * bytes / _clock));
+  }
+
+  // Injected faults, failed transfers take their time as well
+  bool fail(uint16_t bytes) {
+    if(!_stuck && _failures == 0) {
+      _lastError = ERROR_NONE;
+      return false;
+    }
+    if(_failures > 0) _failures--;
+    occupy(bytes);
+    _lastError = _stuck ? ERROR_TIMEOUT : ERROR_DATA_NACK;
+    return true;
+  }
+public:
+  MAX3010xSimulatedBus() : _clock(400000), _failures(0), _stuck(false), _clearable(true), _busClear(true), _busClears(0), _transfers(0) {}
+
+  /**
+   * Simulated sensor
+   * @param addr I2C Device Address
+   * @return Sensor
+   */
+  MAX3010xSimulatedSensor& sensor(uint8_t addr) {
+    return _sensors[addr & 127];
+  }
+
+  /**
+   * Let the next transfers fail with a data NACK
+   * @param count Number of transfers
+   */
+  void injectFailures(uint16_t count) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _failures = count;
+  }
+
+  /**
+   * Hold SDA low, all transfers fail with a timeout
+   * @param stuck true if the bus is stuck
+   * @param clearable true if a bus clear releases the bus
+   */
+  void setStuck(bool stuck, bool clearable = true) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stuck = stuck;
+    _clearable = clearable;
+  }
+
+  /**
+   * Enable bus clear support
+   * @param supported false to let recoverBus() fail without clearing, like a Wire transport without pins
+   */
+  void setBusClearSupported(bool supported) {
+    _busClear = supported;
+  }
+
+  /**
+   * Number of bus clears performed
+   * @return Number of bus clears
+   */
+  uint32_t busClears() const {
+    return _busClears;
+  }
+
+  /**
+   * Number of read and write transfers
+   * @return Number of transfers (including failed ones)
+   */
+  uint32_t transfers() const {
+    return _transfers;
+  }
+
+  void begin() override {}
+
+  bool setClock(uint32_t clock) override {
+    _clock = clock;
+    return true;
+  }
+
+  // Nine clock pulses and a STOP condition at 100 kHz
+  bool recoverBus() override {
+    if(!_busClear) return false;
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    _busClears++;
+    if(_clearable) _stuck = false;
+    return !_stuck;
+  }
+
+  bool read(uint8_t addr, uint8_t reg, uint8_t count, uint8_t* buffer) override {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _transfers++;
+    if(fail(count + 3)) return false;
+    occupy(count + 3);
+    MAX3010xSimulatedSensor& sensor = _sensors[addr & 127];
+    for(uint8_t i = 0; i < count; i++) {
+      buffer[i] = sensor.read(reg == 0x07 ? reg : reg + i);
+    }
+    return true;
+  }
+
+  bool write(uint8_t addr, uint8_t reg, uint8_t count, const uint8_t* buffer) override {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _transfers++;
+    if(fail(count + 2)) return false;
+    occupy(count + 2);
+    MAX3010xSimulatedSensor& sensor = _sensors[addr & 127];
+    for(uint8_t i = 0; i < count; i++) {
+      sensor.write(reg + i, buffer[i]);
+    }
+    return true;
+  }
+};
+
+/**
+ * Simulated I2C Bus with DMA
+ *
+ * readAsync() returns immediately, the transfer is performed by a background thread (the "DMA engine")
+ * which calls the completion callback from its own context, like an interrupt handler on a device.
+ */
+class MAX3010xSimulatedAsyncBus : public MAX3010xSimulatedBus {
+  /**
+   * Pending Read
+   */
+  struct Request {
+    uint8_t addr;
+    uint8_t reg;
+    uint8_t count;
+    uint8_t* buffer;
+    Callback callback;
+    void* context;
+  };
+
+  std::mutex _requestMutex;
+  std::condition_variable _requestCondition;
+  Request _request;
+  bool _pending;
+  bool _stop;
+  std::thread _engine;
+
+  void run() {
+    std::unique_lock<std::mutex> lock(_requestMutex);
+    while(true) {
+      _requestCondition.wait(lock, [this]() { return _pending || _stop; });
+      if(_stop) return;
+
+      const Request request = _request;
+      lock.unlock();
+      const bool success = read(request.addr, request.reg, request.count, request.buffer);
+      lock.lock();
+      _pending = false;
+
+      lock.unlock();
+      request.callback(request.context, success);
+      lock.lock();
+    }
+  }
+public:
+  MAX3010xSimulatedAsyncBus() : _pending(false), _stop(false), _engine(&MAX3010xSimulatedAsyncBus::run, this) {}
+
+  ~MAX3010xSimulatedAsyncBus() {
+    {
+      std::lock_guard<std::mutex> lock(_requestMutex);
+      _stop = true;
+    }
+    _requestCondition.notify_one();
+    _engine.join();
+  }
+
+  bool readAsync(uint8_t addr, uint8_t reg, uint8_t count, uint8_t* buffer, Callback callback, void* context) override {
+    {
+      std::lock_guard<std::mutex> lock(_requestMutex);
+      if(_pending) return false;
+      _request = { addr, reg, count, buffer, callback, context };
+      _pending = true;
+    }
+    _requestCondition.notify_one();
+    return true;
+  }
+};
+
+#endif
@@ -0,0 +1,29 @@
+/*!
+ * @file Wire.h
+ *
+ * Placeholder for the Arduino Wire API on Linux hosts.
+ * The drivers have to be constructed with a MAX3010xTransport (e.g. MAX3010xLinuxTransport),
+ * the Wire instance only satisfies the default constructor arguments and reports every transfer as failed.
+ */
+
+
+#ifndef _MAX3010x_LINUX_WIRE_H
+#define _MAX3010x_LINUX_WIRE_H
+
+#include "Arduino.h"
+
+class TwoWire {
+public:
+  void begin() {}
+  void setClock(uint32_t) {}
+  void beginTransmission(uint8_t) {}
+  size_t write(uint8_t) { return 0; }
+  uint8_t endTransmission(bool = true) { return 4; }
+  uint8_t requestFrom(uint8_t, uint8_t) { return 0; }
+  int available() { return 0; }
+  int read() { return -1; }
+};
+
+static TwoWire Wire;
+
+#endif
@@ -0,0 +1,211 @@
+/*!
+ * @file batchAnalysis.cpp
+ *
+ * Offline analysis of recorded FIFO data with the processing chain of the firmware (MAX3010xAnalyzer).
+ *
+ * A recording holds the raw FIFO bytes as read from the sensor, e.g. written by
+ * sensor.drainRaw([](const MAX3010xRawData& raw) { Serial.write(raw.data, raw.samples * raw.slots * raw.sampleSize); });
+ * The recordings are fed to MAX3010xAnalyzer as MAX3010xRawData batches of the size the firmware
+ * drains (MAX3010x_I2C_BUFFER_SIZE), so the analysis runs exactly the code of the device.
+ * Files are processed in parallel, each file by a single thread.
+ *
+ * For every file a tab separated line with the metrics and the processing time is printed,
+ * a summary with the total throughput is printed to stderr.
+ *
+ * Build and run (from extras/linux):
+ * g++ -std=c++11 -O2 -ffp-contract=off -pthread -I. -I../../src batchAnalysis.cpp -o batchAnalysis
+ * ./batchAnalysis [-j jobs] [-r sampling rate] [-s slots] [-b bytes per value] [-R red slot] [-I IR slot] files...
+ *
+ * Defaults: all cores, 400 SPS, 2 slots with 3 bytes each, red in slot 0, IR in slot 1 (MAX30101/2/5 SpO2 mode).
+ * MAX30100 recordings: -b 2 -R 1 -I 0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "MAX3010x_core.h"
+#include "MAX3010x_analyzer.h"
+
+typedef MAX3010xAnalyzer<> Analyzer;
+
+/**
+ * Recording Format
+ */
+struct Format {
+  float samplingRate;   //!< Sampling rate in Hz
+  uint8_t slots;        //!< Number of slots per sample
+  uint8_t sampleSize;   //!< Size of a slot value in bytes
+  uint8_t redSlot;      //!< Slot of the red LED
+  uint8_t irSlot;       //!< Slot of the IR LED
+};
+
+/**
+ * Metrics of a Recording
+ */
+struct Metrics {
+  bool valid;               //!< File was read successfully
+  uint32_t samples;         //!< Number of samples
+  uint32_t windows;         //!< Number of result windows
+  uint32_t usableWindows;   //!< Number of windows with sufficient signal quality
+  float bpm;                //!< Median heart rate of the usable windows in BPM
+  float confidence;         //!< Mean heart rate confidence of the usable windows
+  float spo2;               //!< Median SpO2 of the usable windows in %
+  float minSpo2;            //!< Minimum SpO2 of the usable windows in %
+  float perfusionIndex;     //!< Mean perfusion index of the IR channel in %
+  float clipping;           //!< Maximum clipping ratio of both channels
+  double seconds;           //!< Processing time in s
+};
+
+/**
+ * Median
+ * @param values Values (reordered)
+ * @return Median or NaN without values
+ */
+static float median(std::vector<float>& values) {
+  if(values.empty()) return NAN;
+  std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+  return values[values.size() / 2];
+}
+
+/**
+ * Analyze a recording
+ * @param path File path
+ * @param format Recording format
+ * @return Metrics
+ */
+static Metrics analyze(const char* path, const Format& format) {
+  Metrics metrics = {};
+  const auto start = std::chrono::steady_clock::now();
+
+  FILE* file = fopen(path, "rb");
+  if(file == nullptr) return metrics;
+
+  std::vector<uint8_t> data;
+  uint8_t block[4096];
+  size_t n;
+  while((n = fread(block, 1, sizeof(block), file)) > 0) data.insert(data.end(), block, block + n);
+  const bool error = ferror(file);
+  fclose(file);
+  if(error) return metrics;
+
+  Analyzer analyzer(format.samplingRate, format.redSlot, format.irSlot, format.sampleSize);
+  std::vector<float> bpm, spo2;
+  double confidence = 0, perfusionIndex = 0;
+
+  const uint16_t sampleBytes = format.slots * format.sampleSize;
+  const uint32_t samples = data.size() / sampleBytes;
+  const uint8_t chunkSamples = MAX3010x_I2C_BUFFER_SIZE / sampleBytes > 0 ? MAX3010x_I2C_BUFFER_SIZE / sampleBytes : 1;
+
+  MAX3010xRawData raw;
+  raw.slots = format.slots;
+  raw.sampleSize = format.sampleSize;
+  raw.resolution = 0;
+
+  for(uint32_t i = 0; i < samples; i += raw.samples) {
+    raw.data = data.data() + i * sampleBytes;
+    raw.samples = samples - i < chunkSamples ? samples - i : chunkSamples;
+
+    analyzer.process(raw, [&](const Analyzer& result) {
+      const float clipping = std::max(result.red().clipping(), result.ir().clipping());
+      if(clipping > metrics.clipping) metrics.clipping = clipping;
+      perfusionIndex += result.ir().perfusionIndex();
+
+      if(!result.usable()) return;
+      metrics.usableWindows++;
+      spo2.push_back(result.spo2() / 256.0f);
+      if(!isnan(result.bpm())) {
+        bpm.push_back(result.bpm());
+        confidence += result.confidence();
+      }
+    });
+  }
+
+  metrics.valid = true;
+  metrics.samples = samples;
+  metrics.windows = analyzer.windows();
+  metrics.bpm = median(bpm);
+  metrics.confidence = bpm.empty() ? NAN : confidence / bpm.size();
+  metrics.minSpo2 = spo2.empty() ? NAN : *std::min_element(spo2.begin(), spo2.end());
+  metrics.spo2 = median(spo2);
+  metrics.perfusionIndex = metrics.windows > 0 ? perfusionIndex / metrics.windows : NAN;
+  metrics.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return metrics;
+}
+
+static void usage(const char* name) {
+  fprintf(stderr, "Usage: %s [-j jobs] [-r sampling rate] [-s slots] [-b bytes per value] [-R red slot] [-I IR slot] files...\n", name);
+}
+
+int main(int argc, char** argv) {
+  Format format = { 400, 2, 3, 0, 1 };
+  unsigned int jobs = std::thread::hardware_concurrency();
+
+  int option;
+  while((option = getopt(argc, argv, "j:r:s:b:R:I:h")) != -1) {
+    switch(option) {
+      case 'j': jobs = atoi(optarg); break;
+      case 'r': format.samplingRate = atof(optarg); break;
+      case 's': format.slots = atoi(optarg); break;
+      case 'b': format.sampleSize = atoi(optarg); break;
+      case 'R': format.redSlot = atoi(optarg); break;
+      case 'I': format.irSlot = atoi(optarg); break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+
+  if(optind >= argc || format.samplingRate <= 0 || format.slots == 0 || format.slots > 4 || (format.sampleSize != 2 && format.sampleSize != 3) ||
+     format.redSlot >= format.slots || format.irSlot >= format.slots) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  const char* const* files = argv + optind;
+  const size_t nFiles = argc - optind;
+  if(jobs == 0) jobs = 1;
+  if(jobs > nFiles) jobs = nFiles;
+
+  // Files are claimed one at a time, so long and short recordings balance across the threads
+  std::vector<Metrics> results(nFiles);
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> threads;
+  const auto start = std::chrono::steady_clock::now();
+
+  for(unsigned int j = 0; j < jobs; j++) {
+    threads.emplace_back([&]() {
+      for(size_t i = next++; i < nFiles; i = next++) results[i] = analyze(files[i], format);
+    });
+  }
+  for(auto& thread : threads) thread.join();
+
+  const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  printf("file\tsamples\tduration_s\twindows\tusable\tbpm\tconfidence\tspo2\tmin_spo2\tpi_ir\tclipping\tprocess_ms\trealtime_x\n");
+
+  uint64_t samples = 0;
+  size_t failed = 0;
+  for(size_t i = 0; i < nFiles; i++) {
+    const Metrics& m = results[i];
+    if(!m.valid) {
+      fprintf(stderr, "%s: read failed\n", files[i]);
+      failed++;
+      continue;
+    }
+
+    const double duration = m.samples / format.samplingRate;
+    samples += m.samples;
+    printf("%s\t%u\t%.1f\t%u\t%.2f\t%.1f\t%.2f\t%.2f\t%.2f\t%.3f\t%.4f\t%.2f\t%.0f\n", files[i], m.samples, duration, m.windows,
+           m.windows > 0 ? static_cast<double>(m.usableWindows) / m.windows : 0.0, m.bpm, m.confidence, m.spo2, m.minSpo2,
+           m.perfusionIndex, m.clipping, m.seconds * 1000, m.seconds > 0 ? duration / m.seconds : 0.0);
+  }
+
+  fprintf(stderr, "%zu files (%zu failed), %llu samples, %u threads, %.3f s, %.0f samples/s\n", nFiles, failed,
+          static_cast<unsigned long long>(samples), jobs, wall, wall > 0 ? samples / wall : 0.0);
+
+  return failed > 0 ? 1 : 0;
+}
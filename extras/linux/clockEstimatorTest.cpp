@@ -0,0 +1,79 @@
+/*!
+ * @file clockEstimatorTest.cpp
+ *
+ * Test of MAX3010xClockEstimator with a simulated sensor whose oscillator deviates from the nominal rate.
+ *
+ * A simulated MAX30105 runs at 400 SPS with an injected oscillator error and is drained every 20 ms,
+ * every drain feeds the estimator. Once per second the FIFO is cleared by setMode() as on a reconfiguration,
+ * the discarded samples must not disturb the estimate. The estimated drift has to match the injected error.
+ *
+ * Build and run (from extras/linux):
+ * g++ -std=c++11 -O2 -pthread -I. -I../../src clockEstimatorTest.cpp ../../src/MAX30105.cpp ../../src/MAX3010x_core.cpp -o clockEstimatorTest
+ * ./clockEstimatorTest [seconds]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "MAX30105.h"
+#include "MAX3010x_clock.h"
+#include "MAX3010x_simulatedBus.h"
+
+static const uint8_t kAddr = 0x57;
+static const float kRate = 400;
+static const unsigned long kDrainIntervalUs = 20000;
+static const float kToleranceppm = 100;
+
+/**
+ * Run the sensor with an oscillator error
+ * @param error Relative oscillator error
+ * @param seconds Duration
+ * @return true if the estimated drift matches the error
+ */
+static bool run(double error, unsigned int seconds) {
+  MAX3010xSimulatedBus bus;
+  MAX30105 sensor(kAddr, bus);
+  bus.sensor(kAddr).setOscillatorError(error);
+
+  if(!sensor.begin(sensor.BUS_CLOCK_FAST) || !sensor.setSamplingRate(sensor.SAMPLING_RATE_400SPS) ||
+     !sensor.setMode(sensor.MODE_SPO2)) {
+    printf("%+8.0f ppm: setup failed\n", error * 1e6);
+    return false;
+  }
+
+  MAX3010xClockEstimator clock(kRate);
+  uint16_t stalled = 0;
+  const unsigned long start = micros();
+  for(unsigned long next = start; next - start < seconds * 1000000ul; next += kDrainIntervalUs) {
+    const long remaining = static_cast<long>(next - micros());
+    if(remaining > 0) delayMicroseconds(remaining);
+
+    // Reconfiguration, the pending samples are discarded
+    if((next - start) % 1000000ul == 500000ul && !sensor.setMode(sensor.MODE_SPO2)) {
+      printf("%+8.0f ppm: setMode failed\n", error * 1e6);
+      return false;
+    }
+
+    sensor.drainRaw([](const MAX3010xRawData&) {});
+    const uint16_t observations = clock.observations();
+    clock.observe(sensor.observedMicros(), sensor.observedSamples());
+    if(clock.observations() == observations) stalled++;
+  }
+
+  // The estimator's drift is relative to the nominal period, the oscillator error to the nominal rate
+  const float expected = error * 1e6;
+  const bool passed = fabsf(clock.drift() - expected) < kToleranceppm && stalled == 0 && sensor.samplesLost() == 0;
+  printf("%+8.0f ppm: estimated %+8.0f ppm, residual %5.1f us, discarded %4u, stalled observations %u  %s\n",
+         expected, clock.drift(), clock.residual(), sensor.samplesDiscarded(), stalled, passed ? "ok" : "FAILED");
+  return passed;
+}
+
+int main(int argc, char** argv) {
+  const unsigned int seconds = argc > 1 ? atoi(argv[1]) : 10;
+
+  bool passed = true;
+  for(double error : { 0.0, 0.02, -0.015, 0.05 }) {
+    if(!run(error, seconds)) passed = false;
+  }
+  return passed ? 0 : 1;
+}
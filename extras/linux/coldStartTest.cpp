@@ -0,0 +1,91 @@
+/*!
+ * @file coldStartTest.cpp
+ *
+ * Test of the startup with a saved configuration (begin(configuration)) on a simulated MAX30105.
+ *
+ * The configuration of the first boot is saved and applied in two situations:
+ * - power-up: the sensor has just been powered (power ready flag set), the software reset is skipped
+ * - warm start: the sensor kept its supply (flag already cleared), it is reset before the configuration is restored
+ * Both are measured at 400 kHz: startup time, time to the first sample, bus transfers and resets.
+ * The test checks that only the warm start resets the sensor, that the power-up needs fewer transfers and that
+ * the sensor ends up with the saved configuration and delivers samples. The exit code is 1 if a check fails.
+ *
+ * The simulated sensor completes a reset immediately, so the saved time covers the reset write and the reset poll.
+ * On the sensor the reset itself adds a few microseconds and possibly further polls.
+ *
+ * Build and run (from extras/linux):
+ * g++ -std=c++11 -O2 -pthread -I. -I../../src coldStartTest.cpp ../../src/MAX30105.cpp ../../src/MAX3010x_core.cpp -o coldStartTest
+ * ./coldStartTest
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "MAX30105.h"
+#include "MAX3010x_simulatedBus.h"
+
+static const uint8_t kAddr = 0x57;
+
+/**
+ * Startup measurement
+ */
+struct Startup {
+  bool started;                       // begin(configuration) and the first sample succeeded
+  bool restored;                      // Registers match the saved configuration
+  unsigned long startupMicros;
+  unsigned long firstSampleMicros;
+  uint32_t transfers;                 // Bus transfers of begin(configuration)
+  uint32_t resets;                    // Sensor resets during begin(configuration)
+};
+
+static Startup measure(MAX3010xSimulatedBus& bus, MAX30105& sensor, const MAX3010xConfiguration& configuration) {
+  Startup result = {};
+  const uint32_t transfers = bus.transfers();
+  const uint32_t resets = sensor.diagnostics().resets;
+
+  result.started = sensor.begin(configuration, sensor.BUS_CLOCK_FAST);
+  result.transfers = bus.transfers() - transfers;
+  result.resets = sensor.diagnostics().resets - resets;
+  result.started = result.started && sensor.readSample(100).valid;
+  result.startupMicros = sensor.diagnostics().startupMicros;
+  result.firstSampleMicros = sensor.diagnostics().firstSampleMicros;
+
+  MAX3010xConfiguration current;
+  result.restored = sensor.saveConfiguration(current) && memcmp(current.registers, configuration.registers, sizeof(current.registers)) == 0 &&
+                    memcmp(current.interrupts, configuration.interrupts, sizeof(current.interrupts)) == 0 &&
+                    current.activeSlots == configuration.activeSlots;
+  return result;
+}
+
+static bool report(const char* name, const Startup& startup, bool ok) {
+  printf("%-12s startup %5lu us, first sample %5lu us, transfers %3u, resets %u  %s\n", name, startup.startupMicros,
+         startup.firstSampleMicros, startup.transfers, startup.resets, ok ? "ok" : "FAILED");
+  return ok;
+}
+
+int main() {
+  MAX3010xSimulatedBus bus;
+  MAX30105 sensor(kAddr, bus);
+
+  // First boot
+  MAX3010xConfiguration configuration;
+  if(!sensor.begin(sensor.BUS_CLOCK_FAST) || !sensor.setSamplingRate(sensor.SAMPLING_RATE_400SPS) ||
+     !sensor.setMode(sensor.MODE_SPO2) || !sensor.saveConfiguration(configuration)) {
+    printf("setup failed\n");
+    return 1;
+  }
+
+  bus.sensor(kAddr).powerUp();
+  const Startup powerUp = measure(bus, sensor, configuration);
+  const Startup warmStart = measure(bus, sensor, configuration);
+
+  bool passed = report("power-up", powerUp, powerUp.started && powerUp.restored && powerUp.resets == 0);
+  passed = report("warm start", warmStart, warmStart.started && warmStart.restored && warmStart.resets == 1) && passed;
+
+  const bool fewer = powerUp.transfers < warmStart.transfers;
+  printf("reset skipped: %u transfers less  %s\n", warmStart.transfers - powerUp.transfers, fewer ? "ok" : "FAILED");
+
+  passed = passed && fewer;
+  if(!passed) printf("FAILED\n");
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,135 @@
+/*!
+ * @file ingestionBenchmark.cpp
+ *
+ * Throughput benchmark of MAX3010xIngestion with simulated I2C buses.
+ *
+ * Every simulated bus carries several MAX30105 (as behind an I2C multiplexer, each with its own address)
+ * that produce samples in real time. Transfers block for the time they would take on the bus.
+ * The benchmark runs the same setup with an increasing number of worker threads and reports the
+ * processed sample rate, the latency from drain to processed and the backpressure.
+ *
+ * Build and run (from extras/linux):
+ * g++ -std=c++11 -O2 -pthread -I. -I../../src -DMAX3010x_I2C_BUFFER_SIZE=192 ingestionBenchmark.cpp ../../src/MAX30105.cpp ../../src/MAX3010x_core.cpp -o ingestionBenchmark
+ * ./ingestionBenchmark [buses] [sensors per bus] [processing load] [seconds] [max workers]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "MAX30105.h"
+#include "MAX3010x_pipeline.h"
+#include "MAX3010x_ingestion.h"
+#include "MAX3010x_simulatedBus.h"
+
+// Filter stages
+class LowPass {
+  float _a, _last;
+public:
+  LowPass(float cutoff, float rate) : _a(1 - expf(-2 * PI * cutoff / rate)), _last(0) {}
+  float process(float value) { return _last += _a * (value - _last); }
+  void reset() { _last = 0; }
+};
+
+class HighPass {
+  LowPass _lowPass;
+public:
+  HighPass(float cutoff, float rate) : _lowPass(cutoff, rate) {}
+  float process(float value) { return value - _lowPass.process(value); }
+  void reset() { _lowPass.reset(); }
+};
+
+class Differentiator {
+  float _last;
+public:
+  Differentiator() : _last(0) {}
+  float process(float value) { float diff = value - _last; _last = value; return diff; }
+  void reset() { _last = 0; }
+};
+
+typedef MAX3010xPipeline<LowPass, HighPass, Differentiator> Pipeline;
+
+/**
+ * Per-Sensor Processing
+ * The pipeline is run load times per sample to model more expensive processing.
+ */
+struct Processing {
+  Pipeline pipelines[2];
+  unsigned int load;
+  volatile float output;
+
+  Processing(unsigned int load) : pipelines{Pipeline(LowPass(5, 400), HighPass(0.5, 400), Differentiator()),
+                                            Pipeline(LowPass(5, 400), HighPass(0.5, 400), Differentiator())}, load(load), output(0) {}
+
+  void operator()(const MAX3010xRawData& raw) {
+    for(uint8_t slot = 0; slot < raw.slots && slot < 2; slot++) {
+      for(uint8_t i = 0; i < raw.samples; i++) {
+        float value = raw.value(i, slot);
+        for(unsigned int n = 0; n < load; n++) value = pipelines[slot].process(value);
+        output = value;
+      }
+    }
+  }
+};
+
+int main(int argc, char** argv) {
+  const unsigned int buses = argc > 1 ? atoi(argv[1]) : 4;
+  const unsigned int sensorsPerBus = argc > 2 ? atoi(argv[2]) : 6;
+  const unsigned int load = argc > 3 ? atoi(argv[3]) : 200;
+  const unsigned int seconds = argc > 4 ? atoi(argv[4]) : 3;
+  const unsigned int cores = std::thread::hardware_concurrency();
+  const unsigned int maxWorkers = argc > 5 ? atoi(argv[5]) : (cores > 1 ? cores : 1);
+
+  printf("%u buses, %u sensors per bus, 400 SPS, 2 slots, load %u, %u cores\n", buses, sensorsPerBus, load, cores);
+  printf("workers  samples/s  mean latency (us)  max latency (us)  backpressure  lost\n");
+
+  for(unsigned int workers = 1; workers <= maxWorkers; workers *= 2) {
+    std::vector<std::unique_ptr<MAX3010xSimulatedBus>> transports;
+    std::vector<std::unique_ptr<MAX30105>> sensors;
+    std::vector<std::unique_ptr<Processing>> processing;
+    MAX3010xIngestion<> ingestion;
+
+    for(unsigned int b = 0; b < buses; b++) {
+      transports.emplace_back(new MAX3010xSimulatedBus());
+      uint8_t bus = ingestion.addBus();
+      for(unsigned int s = 0; s < sensorsPerBus; s++) {
+        MAX30105* sensor = new MAX30105(0x10 + s, *transports.back());
+        sensors.emplace_back(sensor);
+        if(!sensor->begin(sensor->BUS_CLOCK_FAST) || !sensor->setSamplingRate(sensor->SAMPLING_RATE_400SPS)) {
+          printf("Sensor initialization failed\n");
+          return 1;
+        }
+
+        Processing* p = new Processing(load);
+        processing.emplace_back(p);
+        ingestion.addSensor(bus, *sensor, [p](const MAX3010xRawData& raw) { (*p)(raw); });
+      }
+    }
+
+    // Discard the samples buffered during the initialization of the other sensors
+    for(auto& sensor : sensors) sensor->clearFIFO();
+
+    ingestion.start(workers);
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    ingestion.stop();
+
+    uint64_t samples = 0, latencySum = 0, backpressure = 0, lost = 0;
+    uint32_t maxLatency = 0;
+    for(size_t i = 0; i < ingestion.sensors(); i++) {
+      MAX3010xIngestionStats stats = ingestion.stats(i);
+      samples += stats.samples;
+      latencySum += static_cast<uint64_t>(stats.meanLatency) * stats.batches;
+      backpressure += stats.backpressure;
+      lost += stats.samplesLost;
+      if(stats.maxLatency > maxLatency) maxLatency = stats.maxLatency;
+    }
+
+    uint64_t batches = 0;
+    for(size_t i = 0; i < ingestion.sensors(); i++) batches += ingestion.stats(i).batches;
+
+    printf("%7u  %9.0f  %17llu  %16u  %12llu  %4llu\n", workers, static_cast<double>(samples) / seconds,
+           static_cast<unsigned long long>(batches > 0 ? latencySum / batches : 0), maxLatency,
+           static_cast<unsigned long long>(backpressure), static_cast<unsigned long long>(lost));
+  }
+
+  return 0;
+}
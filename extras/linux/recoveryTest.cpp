@@ -0,0 +1,113 @@
+/*!
+ * @file recoveryTest.cpp
+ *
+ * Fault injection test of the bus error recovery (MAX3010xRecoveryPolicy) with a simulated bus.
+ *
+ * A simulated MAX30105 on a 100 kHz bus is reconfigured with setSamplingRate() (a register read and a write)
+ * while faults are injected: consecutive failed transfers, a stuck bus that a bus clear releases or not,
+ * a sensor that lost its configuration and a transport without bus clear support.
+ * For every scenario the outcome, the duration of the call and the recovery steps are reported.
+ * The test checks the expected outcome, the configuration of the sensor afterwards and
+ * that every recovery stays within worstCaseMicros() (a call with two transfers within twice the bound).
+ * The exit code is 1 if a check fails.
+ *
+ * Build and run (from extras/linux):
+ * g++ -std=c++11 -O2 -pthread -I. -I../../src recoveryTest.cpp ../../src/MAX30105.cpp ../../src/MAX3010x_core.cpp -o recoveryTest
+ * ./recoveryTest
+ */
+
+#include <stdio.h>
+
+#include "MAX30105.h"
+#include "MAX3010x_simulatedBus.h"
+
+static const uint8_t kAddr = 0x57;
+static const unsigned long kTransferUs = 1000;    // Upper bound of a register transfer at 100 kHz
+static const uint8_t kSpO2ConfigReg = 0x0A;
+
+/**
+ * Fault scenario
+ */
+struct Scenario {
+  const char* name;
+  uint16_t failures;    // Consecutive failed transfers
+  bool stuck;           // Stuck bus
+  bool clearable;       // Bus clear releases the stuck bus
+  bool busClear;        // Transport supports bus clears
+  bool powerLoss;       // Sensor lost its configuration
+  bool recovers;        // Expected outcome
+};
+
+static const Scenario kScenarios[] = {
+  { "no fault",                  0, false, false, true,  false, true  },
+  { "1 failure (retry)",         1, false, false, true,  false, true  },
+  { "2 failures (retries)",      2, false, false, true,  false, true  },
+  { "3 failures (bus clear)",    3, false, false, true,  false, true  },
+  { "4 failures (reinit)",       4, false, false, true,  false, true  },
+  { "5 failures",                5, false, false, true,  false, false },
+  { "stuck bus, cleared",        0, true,  true,  true,  false, true  },
+  { "stuck bus, not cleared",    0, true,  false, true,  false, false },
+  { "power loss, 4 failures",    4, false, false, true,  true,  true  },
+  { "no bus clear, 3 failures",  3, false, false, false, false, true  },
+};
+
+int main() {
+  MAX3010xSimulatedBus bus;
+  MAX30105 sensor(kAddr, bus);
+  if(!sensor.begin(sensor.BUS_CLOCK_STANDARD) || !sensor.setMode(sensor.MODE_SPO2)) {
+    printf("setup failed\n");
+    return 1;
+  }
+
+  const MAX3010xRecoveryPolicy policy;
+  sensor.setRecoveryPolicy(policy);
+  const unsigned long bound = policy.worstCaseMicros(kTransferUs);
+  printf("worst case per recovery (%lu us transfers): %lu us\n", kTransferUs, bound);
+  printf("scenario                   result     call (us)  recovery (us)  clears  reinits  config\n");
+
+  bool passed = true;
+  bool toggle = false;
+  for(const Scenario& scenario : kScenarios) {
+    const MAX3010xDiagnostics before = sensor.diagnostics();
+
+    // Alternate the sampling rate, so the write is visible in the register
+    toggle = !toggle;
+    const MAX30105::SamplingRate rate = toggle ? sensor.SAMPLING_RATE_200SPS : sensor.SAMPLING_RATE_100SPS;
+
+    bus.setBusClearSupported(scenario.busClear);
+    if(scenario.powerLoss) bus.sensor(kAddr).powerUp();
+    bus.setStuck(scenario.stuck, scenario.clearable);
+    bus.injectFailures(scenario.failures);
+
+    const unsigned long start = micros();
+    const bool success = sensor.setSamplingRate(rate);
+    const unsigned long duration = micros() - start;
+
+    const MAX3010xDiagnostics& after = sensor.diagnostics();
+    const unsigned long recovery = after.recoveries + after.failedRecoveries > before.recoveries + before.failedRecoveries ? after.lastRecoveryMicros : 0;
+
+    // Configuration as seen by the sensor: the new sampling rate and the SpO2 mode (restored after a power loss)
+    bus.setStuck(false);
+    bus.injectFailures(0);
+    bus.setBusClearSupported(true);
+    MAX3010xSimulatedSensor& simulated = bus.sensor(kAddr);
+    const bool configured = ((simulated.read(kSpO2ConfigReg) >> 2) & 7) == static_cast<uint8_t>(rate) && (simulated.read(0x09) & 7) == 3;
+
+    const bool ok = success == scenario.recovers && (!success || configured) && after.maxRecoveryMicros <= bound && duration <= 2 * bound;
+    printf("%-25s  %-9s  %9lu  %13lu  %6u  %7u  %-6s  %s\n", scenario.name, success ? "recovered" : "failed", duration, recovery,
+           after.busClears - before.busClears, after.reinits - before.reinits, configured ? "ok" : "lost", ok ? "ok" : "FAILED");
+    if(!ok) passed = false;
+
+    // Let a back-off after a failed recovery expire and restore the configuration
+    if(!success) {
+      delay(policy.maxBackoffMs);
+      if(!sensor.setMode(sensor.MODE_SPO2)) {
+        printf("no recovery after the back-off\n");
+        passed = false;
+      }
+    }
+  }
+
+  if(!passed) printf("FAILED\n");
+  return passed ? 0 : 1;
+}
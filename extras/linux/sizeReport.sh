@@ -0,0 +1,73 @@
+#!/bin/bash
+#
+# Size report: flash and RAM of the MAX3010xSizeReport example for every combination of supported chips.
+#
+# Usage (from extras/linux):
+#   ./sizeReport.sh                       host build with g++ -Os (text + data, data + bss of the linked program)
+#   ./sizeReport.sh arduino:avr:uno       arduino-cli build for a board (sizes reported by arduino-cli)
+#
+# The table is printed to stdout, the last column is the flash growth relative to the build without sensors.
+# Compare it with the committed baseline to spot regressions, e.g.
+#   ./sizeReport.sh | diff sizeReport_host.txt -
+# The exit code is 1 if a combination fails to build.
+
+set -e -o pipefail
+
+here="$(cd "$(dirname "$0")" && pwd)"
+repo="$(cd "$here/../.." && pwd)"
+sketch="$repo/examples/MAX3010xSizeReport"
+fqbn="$1"
+chips=(MAX30100 MAX30101 MAX30102 MAX30105)
+
+work="$(mktemp -d)"
+trap 'rm -rf "$work"' EXIT
+
+# Host shim: Serial and the Arduino main()
+cat > "$work/host.h" <<'EOF'
+#include "Arduino.h"
+struct HostSerial { void begin(unsigned long) {} };
+static HostSerial Serial;
+EOF
+cat > "$work/main.cpp" <<'EOF'
+void setup();
+void loop();
+int main() {
+  setup();
+  for(;;) loop();
+}
+EOF
+
+# Prints "flash ram" for a set of -D flags
+measure() {
+  if [ -z "$fqbn" ]; then
+    cp "$sketch/MAX3010xSizeReport.ino" "$work/sketch.cpp"
+    g++ -std=gnu++11 -Os -ffunction-sections -fdata-sections -Wl,--gc-sections "$@" -I"$here" -I"$repo/src" \
+        -include "$work/host.h" "$work/sketch.cpp" "$work/main.cpp" "$repo"/src/*.cpp -o "$work/sketch" -pthread || return 1
+    size "$work/sketch" | awk 'NR == 2 { print $1 + $2, $2 + $3 }'
+  else
+    arduino-cli compile -b "$fqbn" --library "$repo" --build-property "compiler.cpp.extra_flags=$*" "$sketch" |
+      awk '/Sketch uses/ { flash = $3 } /Global variables use/ { ram = $4 } END { print flash, ram }'
+  fi
+}
+
+echo "Size report ${fqbn:-host g++ $(g++ -dumpfullversion) -Os}"
+printf "%-36s %8s %8s %8s\n" "chips" "flash" "RAM" "+flash"
+base=
+for mask in $(seq 0 15); do
+  flags=()
+  names=()
+  for i in 0 1 2 3; do
+    if [ $(( (mask >> i) & 1 )) -eq 1 ]; then
+      flags+=("-DSIZE_REPORT_${chips[$i]}=1")
+      names+=("${chips[$i]}")
+    else
+      flags+=("-DSIZE_REPORT_${chips[$i]}=0")
+    fi
+  done
+
+  sizes="$(measure "${flags[@]}")"
+  read -r flash ram <<< "$sizes"
+  [ -z "$base" ] && base=$flash
+  name="${names[*]}"
+  printf "%-36s %8s %8s %8s\n" "${name:-none}" "$flash" "$ram" "$((flash - base))"
+done
@@ -0,0 +1,86 @@
+/*!
+ * @file spectralBenchmark.cpp
+ *
+ * CPU cost and range check of MAX3010xSpectralHeartRate on the host.
+ *
+ * For several window lengths and input rates the time per processed sample and per estimate is measured,
+ * and the estimate is checked against synthetic pulses between 45 and 235 BPM. A configuration
+ * whose search range does not fit kMaxBins has to be rejected by configure().
+ * The exit code is 1 if an estimate is off by more than one bin or a configuration check fails.
+ *
+ * Build and run (from extras/linux):
+ * g++ -std=c++11 -O2 -I. -I../../src spectralBenchmark.cpp -o spectralBenchmark
+ * ./spectralBenchmark
+ */
+
+#include <stdio.h>
+#include <chrono>
+
+#include "Arduino.h"
+#include "MAX3010x_spectralHeartRate.h"
+
+static volatile float sink;
+
+// Synthetic PPG: pulse with its first harmonic on a DC level
+static float generate(long i, float rate, float bpm) {
+  const float t = i / rate;
+  return 50000.0f + 500.0f * sinf(2 * PI * bpm / 60.0f * t) + 150.0f * sinf(4 * PI * bpm / 60.0f * t);
+}
+
+static double nanoseconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<uint16_t kWindow, uint8_t kMaxBins> static bool benchmark(float rate) {
+  static MAX3010xSpectralHeartRate<kWindow, kMaxBins> estimator(rate);
+  if(!estimator.configure(rate)) {
+    printf("%6u  %7.1f  %8u  configuration rejected\n", kWindow, rate, kMaxBins);
+    return false;
+  }
+
+  // Cost per sample and per estimate
+  const long samples = 200000;
+  auto start = std::chrono::steady_clock::now();
+  for(long i = 0; i < samples; i++) estimator.process(generate(i, rate, 72));
+  const double generateNs = nanoseconds(start);
+  start = std::chrono::steady_clock::now();
+  for(long i = 0; i < samples; i++) sink = generate(i, rate, 72);
+  const double processNs = (generateNs - nanoseconds(start)) / samples;
+
+  const int estimates = 10000;
+  start = std::chrono::steady_clock::now();
+  for(int i = 0; i < estimates; i++) estimator.estimate();
+  const double estimateNs = nanoseconds(start) / estimates;
+
+  // Range check, one bin tolerance
+  const float binBpm = rate / kWindow * 60.0f;
+  float maxError = 0;
+  for(float bpm = 45; bpm <= 235; bpm += 10) {
+    estimator.reset();
+    for(long i = 0; i < kWindow; i++) estimator.process(generate(i, rate, bpm));
+    if(!estimator.estimate()) return false;
+    const float error = fabsf(estimator.bpm() - bpm);
+    if(error > maxError) maxError = error;
+  }
+
+  const bool passed = maxError <= binBpm;
+  printf("%6u  %7.1f  %8u  %13.1f  %15.0f  %11.4f  %13.2f  %s\n", kWindow, rate, kMaxBins, processNs, estimateNs,
+         (processNs * rate + estimateNs) * 1e-7, maxError, passed ? "ok" : "FAILED");
+  return passed;
+}
+
+int main() {
+  printf("window  rate Hz  max bins  ns per sample  ns per estimate  host load %%  max error BPM\n");
+
+  bool passed = true;
+  passed &= benchmark<128, 36>(12.5f);
+  passed &= benchmark<256, 48>(25.0f);
+  passed &= benchmark<512, 68>(25.0f);
+  passed &= benchmark<256, 72>(12.5f);
+
+  // 68 bins are needed, truncating them would limit the range to 178 BPM
+  if(benchmark<512, 48>(25.0f)) passed = false;
+
+  if(!passed) printf("FAILED\n");
+  return passed ? 0 : 1;
+}
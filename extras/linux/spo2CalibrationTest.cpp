@@ -0,0 +1,75 @@
+/*!
+ * @file spo2CalibrationTest.cpp
+ *
+ * Accuracy, cost and memory of the temperature compensated SpO2 calibration (MAX3010xSpO2Calibration) on the host.
+ *
+ * The integer path (R in Q10, Q14 correction, flash lookup) is compared with the float model
+ * SpO2 = a * R_c^2 + b * R_c + c, R_c = R / (1 + ratioDrift * (T - referenceTemperature)),
+ * for die temperatures from 0 to 50 °C and ratios from 0.2 to 1.8. The deviation includes the quantization of R.
+ * The exit code is 1 if the deviation exceeds 0.25 % SpO2.
+ *
+ * Build and run (from extras/linux):
+ * g++ -std=c++11 -O2 -I. -I../../src spo2CalibrationTest.cpp -o spo2CalibrationTest
+ * ./spo2CalibrationTest
+ */
+
+#include <stdio.h>
+#include <chrono>
+
+#include "Arduino.h"
+#include "MAX3010x_spo2Calibration.h"
+
+typedef MAX3010xMaximSpO2Calibration Calibration;
+
+static const float kRatioDrift = 0.002f;
+static const float kReferenceTemperature = 25.0f;
+
+static volatile uint32_t sinkInt;
+static volatile float sinkFloat;
+
+static float reference(float ratio, float temperature) {
+  const float r = ratio / (1.0f + kRatioDrift * (temperature - kReferenceTemperature));
+  const float spo2 = Calibration::a * r * r + Calibration::b * r + Calibration::c;
+  return spo2 < 0 ? 0 : spo2 > 100 ? 100 : spo2;
+}
+
+static double nanoseconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+  MAX3010xSpO2Calibration<Calibration> calibration(kRatioDrift, kReferenceTemperature);
+
+  // Deviation from the float model
+  float maxError = 0;
+  float worstRatio = 0;
+  int worstTemperature = 0;
+  for(int temperature = 0; temperature <= 50; temperature++) {
+    calibration.setTemperature(temperature);
+    for(uint16_t ratio = 205; ratio <= 1843; ratio++) {    // 0.2 - 1.8 in Q10
+      const float error = fabsf(calibration.spo2(ratio) / 256.0f - reference(ratio / 1024.0f, temperature));
+      if(error > maxError) {
+        maxError = error;
+        worstRatio = ratio / 1024.0f;
+        worstTemperature = temperature;
+      }
+    }
+  }
+
+  // Cost per beat: integer lookup and the float model
+  const long calls = 10000000;
+  calibration.setTemperature(37);
+  auto start = std::chrono::steady_clock::now();
+  for(long i = 0; i < calls; i++) sinkInt = calibration.spo2(205 + i % 1639);
+  const double integerNs = nanoseconds(start) / calls;
+  start = std::chrono::steady_clock::now();
+  for(long i = 0; i < calls; i++) sinkFloat = reference((205 + i % 1639) / 1024.0f, 37);
+  const double floatNs = nanoseconds(start) / calls;
+
+  const bool passed = maxError <= 0.25f;
+  printf("max deviation: %.3f %% SpO2 (R %.3f, %d C)  %s\n", maxError, worstRatio, worstTemperature, passed ? "ok" : "FAILED");
+  printf("ns per beat: integer %.1f, float %.1f\n", integerNs, floatNs);
+  printf("RAM: %u bytes, lookup table in flash: %u bytes\n", static_cast<unsigned>(sizeof(calibration)),
+         static_cast<unsigned>(MAX3010xSpO2Lookup<Calibration>::ENTRIES * sizeof(uint16_t)));
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+/*!
+ * @file syncGroupTest.cpp
+ *
+ * Test of MAX3010xSyncGroup with two simulated sensors whose oscillators deviate differently from the nominal rate.
+ *
+ * Two MAX30105 on one simulated bus run at 400 SPS with injected oscillator errors and are drained together
+ * every 60 ms (24 samples per drain). Every output frame is compared with the signal the simulated sensor
+ * produced at the frame time. The deviation is converted into a timing error using the slope of the signal.
+ * The test checks the mean timing error of each sensor and of the alignment between them, the frame rate and
+ * that no frames were skipped. The exit code is 1 if a check fails.
+ *
+ * The driver timestamps the FIFO pointer read at its start, the simulated sensor latches the pointers at the end
+ * of the transfer. Both sensors share this bias of about 200 us, so it is not part of the alignment error.
+ *
+ * Build and run (from extras/linux):
+ * g++ -std=c++11 -O2 -pthread -I. -I../../src syncGroupTest.cpp ../../src/MAX30105.cpp ../../src/MAX3010x_core.cpp -o syncGroupTest
+ * ./syncGroupTest [seconds]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "MAX30105.h"
+#include "MAX3010x_syncGroup.h"
+#include "MAX3010x_simulatedBus.h"
+
+static const uint8_t kAddr[2] = { 0x57, 0x58 };
+static const double kError[2] = { 0.01, -0.015 };
+static const float kRate = 400;
+static const unsigned long kDrainIntervalUs = 60000;
+static const unsigned long kWarmupUs = 1000000;     // Convergence of the clock estimators
+static const float kToleranceUs = 500;              // Mean absolute timing error of a sensor (1/5 sample period)
+static const float kAlignmentToleranceUs = 250;     // Mean absolute alignment error (1/10 sample period)
+
+/**
+ * Timing error statistic of a sensor
+ */
+struct TimingError {
+  double sum;             // Sum of the timing errors in us
+  double absSum;          // Sum of the absolute timing errors in us
+  unsigned long count;
+
+  double mean() const {
+    return count > 0 ? sum / count : 0;
+  }
+
+  double meanAbs() const {
+    return count > 0 ? absSum / count : 0;
+  }
+};
+
+int main(int argc, char** argv) {
+  const unsigned int seconds = argc > 1 ? atoi(argv[1]) : 10;
+
+  MAX3010xSimulatedBus bus;
+  MAX30105 sensors[2] = { MAX30105(kAddr[0], bus), MAX30105(kAddr[1], bus) };
+  MAX3010xSyncGroup<2> group(kRate);
+
+  for(uint8_t s = 0; s < 2; s++) {
+    bus.sensor(kAddr[s]).setOscillatorError(kError[s]);
+    if(!sensors[s].begin(sensors[s].BUS_CLOCK_FAST) || !sensors[s].setSamplingRate(sensors[s].SAMPLING_RATE_400SPS) ||
+       !sensors[s].setMode(sensors[s].MODE_SPO2)) {
+      printf("setup failed\n");
+      return 1;
+    }
+    group.attach(s, sensors[s], kRate);
+  }
+
+  TimingError errors[2] = {};
+  TimingError alignment = {};
+  unsigned long frames = 0;
+  unsigned long startUs = micros();
+  for(unsigned long next = startUs; next - startUs < seconds * 1000000ul; next += kDrainIntervalUs) {
+    const long remaining = static_cast<long>(next - micros());
+    if(remaining > 0) delayMicroseconds(remaining);
+
+    group.update([&](const MAX3010xSyncGroup<2>::Frame& frame) {
+      frames++;
+      if(frame.time - startUs < kWarmupUs) return;
+
+      // Timing error from the deviation of the IR slot, only where the signal is steep enough
+      double offset[2];
+      bool valid = true;
+      for(uint8_t s = 0; s < 2; s++) {
+        const double x = bus.sensor(kAddr[s]).indexAt(frame.time);
+        const uint64_t i = static_cast<uint64_t>(x);
+        const double v0 = MAX3010xSimulatedSensor::value(i, 1);
+        const double v1 = MAX3010xSimulatedSensor::value(i + 1, 1);
+        const double slope = v1 - v0;     // Per sample
+        if(fabs(slope) < 20) {
+          valid = false;
+          continue;
+        }
+        const double expected = v0 + (x - i) * slope;
+        const double period = 1e6 / (kRate * (1 + kError[s]));
+        offset[s] = (frame.value[s][1] - expected) / slope * period;
+      }
+      if(!valid) return;
+
+      for(uint8_t s = 0; s < 2; s++) {
+        errors[s].sum += offset[s];
+        errors[s].absSum += fabs(offset[s]);
+        errors[s].count++;
+      }
+      alignment.sum += offset[0] - offset[1];
+      alignment.absSum += fabs(offset[0] - offset[1]);
+      alignment.count++;
+    });
+  }
+  const double frameRate = frames * 1e6 / (micros() - startUs);
+
+  bool passed = true;
+  for(uint8_t s = 0; s < 2; s++) {
+    const bool ok = errors[s].meanAbs() < kToleranceUs && sensors[s].samplesLost() == 0;
+    printf("sensor %u %+6.0f ppm: estimated %+6.0f ppm, timing error mean %+6.1f us, mean abs %5.1f us, residual %5.1f us, lost %u  %s\n",
+           s, kError[s] * 1e6, group.clock(s).drift(), errors[s].mean(), errors[s].meanAbs(), group.residual(s),
+           sensors[s].samplesLost(), ok ? "ok" : "FAILED");
+    if(!ok) passed = false;
+  }
+
+  const bool aligned = alignment.meanAbs() < kAlignmentToleranceUs && alignment.count > 0;
+  printf("alignment: mean %+6.1f us, mean abs %5.1f us, estimated error %5.1f us  %s\n",
+         alignment.mean(), alignment.meanAbs(), group.alignmentError(), aligned ? "ok" : "FAILED");
+
+  const bool complete = group.skippedFrames() == 0 && fabs(frameRate - kRate) < 0.02 * kRate;
+  printf("frames: %lu (%.1f per s), skipped %u  %s\n", frames, frameRate, group.skippedFrames(), complete ? "ok" : "FAILED");
+
+  passed = passed && aligned && complete;
+  if(!passed) printf("FAILED\n");
+  return passed ? 0 : 1;
+}
@@ -4,47 +4,27 @@
 
 #include "MAX30100.h"
 
-const uint8_t MAX30100::INT_CFG_REG[] = {
-  0x01,                                     //!< FIFO Almost Full Interrupt Enable Register
-  0x01,                                     //!< Temperature Ready Interrupt Enable Register
-  0x01,                                     //!< HR Ready Interrupt Enable Register    
-  0x01,                                     //!< SPO2 Ready Interrupt Enable Register
-  0xFF                                      //!< Power Ready Status Interrupt Enable Register (not existing)
-};
-
-const uint8_t MAX30100::INT_CFG_BIT[] = {
-  7,                                        //!< FIFO Almost Full Interrupt Enable Bit
-  6,                                        //!< Temperature Ready Interrupt Enable Bit
-  5,                                        //!< HR Ready Interrupt Enable Bit    
-  4,                                        //!< SPO2 Ready Interrupt Enable Bit
-  255                                       //!< Power Ready Interrupt Enable Bit (not existing)
-};
-
-const uint8_t MAX30100::INT_ST_REG[] = {
-  0x00,                                     //!< FIFO Almost Full Status Register
-  0x00,                                     //!< Temperature Ready Status Register
-  0x00,                                     //!< HR Ready Status Register    
-  0x00,                                     //!< SPO2 Ready Status Register
-  0x00                                      //!< Power Ready Status Register
-};
-
-const uint8_t MAX30100::INT_ST_BIT[] = {
-  7,                                        //!< FIFO Almost Full Status Bit
-  6,                                        //!< Temperature Ready Status Bit
-  5,                                        //!< HR Ready Status Bit    
-  4,                                        //!< SPO2 Ready Status Bit
-  0                                         //!< Power Ready Status Bit
-};
-  
 /**
  * Constructor
  * Initializes a new sensor instance
+ * @remarks Bus clears of the error recovery need the SDA and SCL pins, pass a MAX3010xWireTransport with pins instead
  * 
  * @param addr Sensor Address (default 0x57)
  * @param wire TWI bus instance (default Wire)
  */
 MAX30100::MAX30100(uint8_t addr, TwoWire& wire) : MAX3010x(addr, wire) {
-  
+  nActiveSlots = 2;   // Always 2 for MAX30100
+}
+
+/**
+ * Constructor
+ * Initializes a new sensor instance using a custom transport
+ * 
+ * @param addr Sensor Address
+ * @param transport Bus transport
+ */
+MAX30100::MAX30100(uint8_t addr, MAX3010xTransport& transport) : MAX3010x(addr, transport) {
+  nActiveSlots = 2;   // Always 2 for MAX30100
 }
 
 /**
@@ -104,14 +84,7 @@ bool MAX30100::setLedCurrent(MAX30100::Led led, MAX30100::LedCurrent current) {
  * @returns true if successful, otherwise false
  */
 bool MAX30100::setSamplingRate(MAX30100::SamplingRate rate) {
-  uint8_t cfg;
-  
-  if(!readByte(SPO2_CFG_REG, cfg)) return false;
-  
-  cfg &= ~(0x7 << 2);
-  cfg |= static_cast<uint8_t>(rate) << 2;
-  
-  return writeByte(SPO2_CFG_REG, cfg);
+  return setField<SamplingRateField>(static_cast<uint8_t>(rate));
 }
 
 /**
@@ -120,12 +93,8 @@ bool MAX30100::setSamplingRate(MAX30100::SamplingRate rate) {
  * @returns true if successful, otherwise false
  */
 bool MAX30100::setResolution(MAX30100::Resolution resolution) {
-  uint8_t cfg;
-  
-  if(!readByte(SPO2_CFG_REG, cfg)) return false;
+  if(!setField<ResolutionField>(static_cast<uint8_t>(resolution))) return false;
   
-  cfg &= ~0x3;
-  cfg |= static_cast<uint8_t>(resolution);
-  
-  return writeByte(SPO2_CFG_REG, cfg);
+  resolutionBits = 13 + static_cast<uint8_t>(resolution);
+  return true;
 }
@@ -47,13 +47,15 @@ private:
   static const uint8_t SPO2_CFG_REG = 0x7;        //!< SpO2 Measurement Configuration Register
   static const uint8_t LED_CFG_REG = 0x9;         //!< LED Configuration Register
   
-  static const uint8_t INT_CNT = 5;
-  static const uint8_t INT_CFG_REG[INT_CNT];      //!< Array to map interrupts to the corresponding configuration register
-  static const uint8_t INT_CFG_BIT[INT_CNT];      //!< Array to map interrupts to the corresponding configuration bits
-  static const uint8_t INT_ST_REG[INT_CNT];       //!< Array to map interrupts to the corresponding status register
-  static const uint8_t INT_ST_BIT[INT_CNT];       //!< Array to map interrupts to the corresponding status bits
+  static const uint8_t INT_ENABLE_REG = 0x1;      //!< First Interrupt Enable Register
+  static const uint8_t INT_ENABLE_SIZE = 1;       //!< Number of Interrupt Enable Registers
+  static const uint8_t CONFIG_REG = MODE_CFG_REG; //!< First Configuration Register
+  static const uint8_t CONFIG_SIZE = 4;           //!< Number of Configuration Registers (up to the LED configuration)
+  static const uint8_t PROX_INT_TRESH_REG = 0;    //!< Proximity Interrupt Threshold Register (not available)
+  static const uint8_t RESET_ACTIVE_SLOTS = 2;    //!< Active slots after a reset (the FIFO always holds red and IR)
   
-  const uint8_t nActiveSlots = 2;                 //!< Number of active LED Slots in FIFO data (always 2 for MAX30100)
+  typedef MAX3010xField<SPO2_CFG_REG, 0, 0x3> ResolutionField;    //!< Resolution Field
+  typedef MAX3010xField<SPO2_CFG_REG, 2, 0x7> SamplingRateField;  //!< Sampling Rate Field
   
   bool setDefaultConfiguration();
   void fillSampleWithData(uint8_t data[SAMPLE_SIZE*MAX_ACTIVE_LEDS], MAX30100Sample& sample);
@@ -129,13 +131,14 @@ public:
   /*
    * MAX30100 Interrupts
    */
-  static const uint8_t INT_A_FULL = 0;            //!< FIFO Almost Full Interrupt
-  static const uint8_t INT_TEMP_RDY = 1;          //!< Temperature Ready Interrupt
-  static const uint8_t INT_HR_RDY = 2;            //!< HR Ready Interrupt
-  static const uint8_t INT_SPO2_RDY = 3;          //!< SPO2 Ready Interrupt
-  static const uint8_t INT_PWR_RDY = 4;           //!< Power Ready Interrupt
+  static const MAX3010xInterrupt INT_A_FULL = MAX3010xInterruptDescriptor::make(0x01, 7, 0x00, 7);   //!< FIFO Almost Full Interrupt
+  static const MAX3010xInterrupt INT_TEMP_RDY = MAX3010xInterruptDescriptor::make(0x01, 6, 0x00, 6); //!< Temperature Ready Interrupt
+  static const MAX3010xInterrupt INT_HR_RDY = MAX3010xInterruptDescriptor::make(0x01, 5, 0x00, 5);   //!< HR Ready Interrupt
+  static const MAX3010xInterrupt INT_SPO2_RDY = MAX3010xInterruptDescriptor::make(0x01, 4, 0x00, 4); //!< SPO2 Ready Interrupt
+  static const MAX3010xInterrupt INT_PWR_RDY = MAX3010xInterruptDescriptor::make(0x00, 0);           //!< Power Ready Interrupt
     
   MAX30100(uint8_t addr = MAX3010x_ADDR, TwoWire& wire = Wire);
+  MAX30100(uint8_t addr, MAX3010xTransport& transport);
   bool setLedCurrent(Led led, LedCurrent current);
   bool setSamplingRate(SamplingRate rate);
   bool setResolution(Resolution resolution);
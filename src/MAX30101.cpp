@@ -4,41 +4,10 @@
 
 #include "MAX30101.h"
 
-const uint8_t MAX30101::INT_CFG_REG[] = {
-  0x02,                                     //!< FIFO Almost Full Interrupt Enable Register
-  0x03,                                     //!< Temperature Ready Interrupt Enable Register
-  0x02,                                     //!< PPG Ready Interrupt Enable Register    
-  0x02,                                     //!< Ambient Light Cancellation Overflow Interrupt Enable Register
-  0xFF                                      //!< Power Ready Status Interrupt Enable Register (not existing)
-};
-
-const uint8_t MAX30101::INT_CFG_BIT[] = {
-  7,                                        //!< FIFO Almost Full Interrupt Enable Bit
-  1,                                        //!< Temperature Ready Interrupt Enable Bit
-  6,                                        //!< PPG Ready Interrupt Enable Bit    
-  5,                                        //!< Ambient Light Cancellation Overflow Interrupt Enable Bit
-  255                                       //!< Power Ready Interrupt Enable Bit (not existing)
-};
-
-const uint8_t MAX30101::INT_ST_REG[] = {
-  0x00,                                     //!< FIFO Almost Full Interrupt Status Register
-  0x01,                                     //!< Temperature Ready Interrupt Status Register
-  0x00,                                     //!< PPG Ready Interrupt Status Register    
-  0x00,                                     //!< Ambient Light Cancellation Overflow Interrupt Status Register
-  0x00                                      //!< Power Ready Interrupt Status Register
-};
-
-const uint8_t MAX30101::INT_ST_BIT[] = {
-  7,                                        //!< FIFO Almost Full Interrupt Status Bit
-  1,                                        //!< Temperature Ready Interrupt Status Bit
-  6,                                        //!< PPG Ready Interrupt Status Bit    
-  5,                                        //!< Ambient Light Cancellation Overflow Interrupt Status Bit
-  0                                         //!< Power Ready Interrupt Status Bit
-};
-
 /**
  * Constructor
  * Initializes a new sensor instance
+ * @remarks Bus clears of the error recovery need the SDA and SCL pins, pass a MAX3010xWireTransport with pins instead
  * 
  * @param addr Sensor Address (default 0x57)
  * @param wire TWI bus instance (default Wire)
@@ -47,6 +16,17 @@ MAX30101::MAX30101(uint8_t addr, TwoWire& wire) : MAX3010xMultiLed(addr, wire) {
   
 }
 
+/**
+ * Constructor
+ * Initializes a new sensor instance using a custom transport
+ * 
+ * @param addr Sensor Address
+ * @param transport Bus transport
+ */
+MAX30101::MAX30101(uint8_t addr, MAX3010xTransport& transport) : MAX3010xMultiLed(addr, transport) {
+  
+}
+
 /**
  * Set Default Configuration
  * @returns true if successful, otherwise false
@@ -31,24 +31,19 @@ class MAX30102 : public MAX3010xMultiLed<MAX30102, MAX30102Sample> {
   static const uint8_t FIFO_SIZE = 32;            //!< FIFO Size (Number of samples)
   static const uint8_t MAX_ACTIVE_LEDS = 4;       //!< Maximum number of active LEDs
   
-  static const uint8_t INT_CNT = 5;
-  static const uint8_t INT_CFG_REG[INT_CNT];      //!< Array to map interrupts to the corresponding configuration register
-  static const uint8_t INT_CFG_BIT[INT_CNT];      //!< Array to map interrupts to the corresponding configuration bits
-  static const uint8_t INT_ST_REG[INT_CNT];       //!< Array to map interrupts to the corresponding status register
-  static const uint8_t INT_ST_BIT[INT_CNT];       //!< Array to map interrupts to the corresponding status bits
-  
   bool setDefaultConfiguration();
 public:
   /*
    * MAX30102 Interrupts
    */
-  static const uint8_t INT_A_FULL = 0;            //!< FIFO Almost Full Interrupt
-  static const uint8_t INT_TEMP_RDY = 1;          //!< Temperature Ready Interrupt
-  static const uint8_t INT_PPG_RDY = 2;           //!< PPG Ready Interrupt
-  static const uint8_t INT_ALC_OVF = 3;           //!< Ambient Light Cancellation Overflow Interrupt
-  static const uint8_t INT_PWR_RDY = 4;           //!< Power Ready Interrupt
+  static const MAX3010xInterrupt INT_A_FULL = MAX3010xInterruptDescriptor::make(0x02, 7, 0x00, 7);   //!< FIFO Almost Full Interrupt
+  static const MAX3010xInterrupt INT_TEMP_RDY = MAX3010xInterruptDescriptor::make(0x03, 1, 0x01, 1); //!< Temperature Ready Interrupt
+  static const MAX3010xInterrupt INT_PPG_RDY = MAX3010xInterruptDescriptor::make(0x02, 6, 0x00, 6);  //!< PPG Ready Interrupt
+  static const MAX3010xInterrupt INT_ALC_OVF = MAX3010xInterruptDescriptor::make(0x02, 5, 0x00, 5);  //!< Ambient Light Cancellation Overflow Interrupt
+  static const MAX3010xInterrupt INT_PWR_RDY = MAX3010xInterruptDescriptor::make(0x00, 0);           //!< Power Ready Interrupt
   
   MAX30102(uint8_t addr = MAX3010x_ADDR, TwoWire& wire = Wire);
+  MAX30102(uint8_t addr, MAX3010xTransport& transport);
   
   /**
    * LED (IR or red)
@@ -4,45 +4,10 @@
 
 #include "MAX30105.h"
 
-const uint8_t MAX30105::INT_CFG_REG[] = {
-  0x02,                                     //!< FIFO Almost Full Interrupt Enable Register
-  0x03,                                     //!< Temperature Ready Interrupt Enable Register
-  0x02,                                     //!< PPG Ready Interrupt Enable Register    
-  0x02,                                     //!< Ambient Light Cancellation Overflow Interrupt Enable Register
-  0x02,                                     //!< Proximity Interrupt Enable Register
-  0xFF                                      //!< Power Ready Status Interrupt Enable Register (not existing)
-};
-
-const uint8_t MAX30105::INT_CFG_BIT[] = {
-  7,                                        //!< FIFO Almost Full Interrupt Enable Bit
-  1,                                        //!< Temperature Ready Interrupt Enable Bit
-  6,                                        //!< PPG Ready Interrupt Enable Bit    
-  5,                                        //!< Ambient Light Cancellation Overflow Interrupt Enable Bit
-  4,                                        //!< Proximity Interrupt Enable Bit
-  255                                       //!< Power Ready Interrupt Enable Bit (not existing)
-};
-
-const uint8_t MAX30105::INT_ST_REG[] = {
-  0x00,                                     //!< FIFO Almost Full Interrupt Status Register
-  0x01,                                     //!< Temperature Ready Interrupt Status Register
-  0x00,                                     //!< PPG Ready Interrupt Status Register    
-  0x00,                                     //!< Ambient Light Cancellation Overflow Interrupt Status Register
-  0x00,                                     //!< Proximity Interrupt Status Register
-  0x00                                      //!< Power Ready Interrupt Status Register
-};
-
-const uint8_t MAX30105::INT_ST_BIT[] = {
-  7,                                        //!< FIFO Almost Full Interrupt Status Bit
-  1,                                        //!< Temperature Ready Interrupt Status Bit
-  6,                                        //!< PPG Ready Interrupt Status Bit    
-  5,                                        //!< Ambient Light Cancellation Overflow Interrupt Status Bit
-  4,                                        //!< Proximity Interrupt Status Bit
-  0                                         //!< Power Ready Interrupt Status Bit
-};
-
 /**
  * Constructor
  * Initializes a new sensor instance
+ * @remarks Bus clears of the error recovery need the SDA and SCL pins, pass a MAX3010xWireTransport with pins instead
  * 
  * @param addr Sensor Address (default 0x57)
  * @param wire TWI bus instance (default Wire)
@@ -51,6 +16,17 @@ MAX30105::MAX30105(uint8_t addr, TwoWire& wire) : MAX3010xMultiLed(addr, wire) {
   
 }
 
+/**
+ * Constructor
+ * Initializes a new sensor instance using a custom transport
+ * 
+ * @param addr Sensor Address
+ * @param transport Bus transport
+ */
+MAX30105::MAX30105(uint8_t addr, MAX3010xTransport& transport) : MAX3010xMultiLed(addr, transport) {
+  
+}
+
 /**
  * Set Default Configuration
  * @returns true if successful, otherwise false
@@ -94,13 +70,37 @@ bool MAX30105::setProximityLedCurrent(uint8_t current) {
 
 /**
  * Set Proximity Interrupt Threshold
- * @param threshold Threshold
+ * @param threshold Threshold (8 MSBs of the 18 bit IR ADC count)
  * @returns true if successful, otherwise false
  */
 bool MAX30105::setProximityThreshold(uint8_t threshold) {
   return writeByte(PROX_INT_TRESH_REG, threshold);
 }
 
+/**
+ * Enter proximity mode
+ * @remarks
+ * The sensor measures with the pilot LED current (see setProximityLedCurrent()) and does not fill the FIFO
+ * until the IR value exceeds the proximity threshold. It then switches to the configured mode by itself and
+ * sets the INT_PROX_RDY interrupt flag.
+ * @returns true if successful, otherwise false
+ */
+bool MAX30105::enterProximityMode() {
+  if(!enableInterrupt<INT_PROX_RDY>()) return false;
+  
+  // Writing the mode register restarts the proximity function
+  return setMode(static_cast<Mode>(currentMode));
+}
+
+/**
+ * Leave proximity mode and measure in the configured mode immediately
+ * @returns true if successful, otherwise false
+ */
+bool MAX30105::exitProximityMode() {
+  if(!disableInterrupt<INT_PROX_RDY>()) return false;
+  return setMode(static_cast<Mode>(currentMode));
+}
+
 /**
  * Set Multi LED Configuration
  * @param cfg Multi LED Configuration
@@ -34,25 +34,20 @@ class MAX30105 : public MAX3010xMultiLed<MAX30105, MAX30105Sample> {
   static const uint8_t PILOT_LED_CFG_REG = 0x10;  //!< Proximity Mode LED Power Configuration Register
   static const uint8_t PROX_INT_TRESH_REG = 0x30; //!< Proximity Interrupt Threshold Register
   
-  static const uint8_t INT_CNT = 6;
-  static const uint8_t INT_CFG_REG[INT_CNT];      //!< Array to map interrupts to the corresponding configuration register
-  static const uint8_t INT_CFG_BIT[INT_CNT];      //!< Array to map interrupts to the corresponding configuration bits
-  static const uint8_t INT_ST_REG[INT_CNT];       //!< Array to map interrupts to the corresponding status register
-  static const uint8_t INT_ST_BIT[INT_CNT];       //!< Array to map interrupts to the corresponding status bits
-  
   bool setDefaultConfiguration();
 public:
   /*
    * MAX30105 Interrupts
    */
-  static const uint8_t INT_A_FULL = 0;            //!< FIFO Almost Full Interrupt
-  static const uint8_t INT_TEMP_RDY = 1;          //!< Temperature Ready Interrupt
-  static const uint8_t INT_PPG_RDY = 2;           //!< PPG Ready Interrupt
-  static const uint8_t INT_ALC_OVF = 3;           //!< Ambient Light Cancellation Overflow Interrupt
-  static const uint8_t INT_PROX_RDY = 4;          //!< Proximity Interrupt
-  static const uint8_t INT_PWR_RDY = 5;           //!< Power Ready Interrupt
+  static const MAX3010xInterrupt INT_A_FULL = MAX3010xInterruptDescriptor::make(0x02, 7, 0x00, 7);   //!< FIFO Almost Full Interrupt
+  static const MAX3010xInterrupt INT_TEMP_RDY = MAX3010xInterruptDescriptor::make(0x03, 1, 0x01, 1); //!< Temperature Ready Interrupt
+  static const MAX3010xInterrupt INT_PPG_RDY = MAX3010xInterruptDescriptor::make(0x02, 6, 0x00, 6);  //!< PPG Ready Interrupt
+  static const MAX3010xInterrupt INT_ALC_OVF = MAX3010xInterruptDescriptor::make(0x02, 5, 0x00, 5);  //!< Ambient Light Cancellation Overflow Interrupt
+  static const MAX3010xInterrupt INT_PROX_RDY = MAX3010xInterruptDescriptor::make(0x02, 4, 0x00, 4); //!< Proximity Interrupt
+  static const MAX3010xInterrupt INT_PWR_RDY = MAX3010xInterruptDescriptor::make(0x00, 0);           //!< Power Ready Interrupt
   
   MAX30105(uint8_t addr = MAX3010x_ADDR, TwoWire& wire = Wire);
+  MAX30105(uint8_t addr, MAX3010xTransport& transport);
   
   /**
    * LED
@@ -70,6 +65,8 @@ public:
   bool setLedCurrent(Led led, uint8_t current);
   bool setProximityLedCurrent(uint8_t current);
   bool setProximityThreshold(uint8_t threshold);
+  bool enterProximityMode();
+  bool exitProximityMode();
   
   /**
    * Slot Configuration
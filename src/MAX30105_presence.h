@@ -0,0 +1,158 @@
+/*!
+ * @file MAX30105_presence.h
+ */
+
+
+#ifndef _MAX30105_PRESENCE_H
+#define _MAX30105_PRESENCE_H
+
+#include "MAX30105.h"
+
+/**
+ * MAX30105 Presence Detector
+ *
+ * Uses the proximity function of the MAX30105 to wait for a finger with the low pilot LED current.
+ * Once the IR value exceeds the proximity threshold the sensor switches to the configured mode by itself.
+ * When the measured value stays below the absence threshold for the configured time,
+ * the sensor is put back into proximity mode.
+ *
+ * The time spent in proximity mode and in measurement mode is accumulated to evaluate the LED power savings:
+ * The average LED current is approximately
+ * (pilotCurrent * proximityTime() + ledCurrent * measurementTime()) / (proximityTime() + measurementTime()).
+ */
+class MAX30105PresenceDetector {
+  MAX30105& _sensor;                //!< Sensor
+  uint32_t _absenceThreshold;       //!< Sample value below which the finger is considered absent
+  unsigned int _absenceTimeMs;      //!< Time the value has to stay below the threshold
+  bool _present;                    //!< Presence state
+  bool _waitingForSample;           //!< Presence detected, no sample processed yet
+  unsigned long _stateSince;        //!< Time of the last state change in ms
+  unsigned long _lowSince;          //!< Time since the value is below the threshold in ms
+  unsigned long _proximityTime;     //!< Accumulated time in proximity mode in ms
+  unsigned long _measurementTime;   //!< Accumulated time in measurement mode in ms
+  unsigned long _latency;           //!< Time from presence detection to the first sample in ms
+
+  /**
+   * Change state and account the time spent in the previous state
+   * @param present New state
+   */
+  void changeState(bool present) {
+    unsigned long now = millis();
+    if(_present) _measurementTime += now - _stateSince;
+    else _proximityTime += now - _stateSince;
+
+    _present = present;
+    _stateSince = now;
+    _lowSince = now;
+  }
+public:
+  /**
+   * Constructor
+   * @param sensor Sensor
+   * @param absenceThreshold Sample value below which the finger is considered absent
+   * @param absenceTimeMs Time in ms the value has to stay below the threshold
+   */
+  MAX30105PresenceDetector(MAX30105& sensor, uint32_t absenceThreshold = 10000, unsigned int absenceTimeMs = 500) :
+    _sensor(sensor),
+    _absenceThreshold(absenceThreshold),
+    _absenceTimeMs(absenceTimeMs),
+    _present(false),
+    _waitingForSample(false),
+    _stateSince(0),
+    _lowSince(0),
+    _proximityTime(0),
+    _measurementTime(0),
+    _latency(0) {}
+
+  /**
+   * Configure the proximity function and enter proximity mode
+   * @remarks Configure mode and LEDs of the sensor before calling this method
+   * @param proximityThreshold Proximity threshold (8 MSBs of the 18 bit IR ADC count)
+   * @param pilotCurrent Pilot LED current in 0.2 mA steps
+   * @return true if successful, otherwise false
+   */
+  bool begin(uint8_t proximityThreshold = 0x14, uint8_t pilotCurrent = 0x19) {
+    if(!_sensor.setProximityLedCurrent(pilotCurrent)) return false;
+    if(!_sensor.setProximityThreshold(proximityThreshold)) return false;
+    if(!_sensor.enterProximityMode()) return false;
+
+    _present = false;
+    _stateSince = millis();
+    return true;
+  }
+
+  /**
+   * Check for the proximity interrupt while no finger is present
+   * @remarks Reading the interrupt status clears the other interrupt flags of the status register
+   * @return true if the presence state changed, otherwise false
+   */
+  bool update() {
+    if(_present) return false;
+    if(!_sensor.checkInterruptFlag(MAX30105::INT_PROX_RDY)) return false;
+
+    changeState(true);
+    _waitingForSample = true;
+    return true;
+  }
+
+  /**
+   * Process a measurement value while a finger is present
+   * @param value Measurement value used for detection (e.g. IR or red)
+   * @return true if the presence state changed, otherwise false
+   */
+  bool process(uint32_t value) {
+    if(!_present) return false;
+
+    unsigned long now = millis();
+    if(_waitingForSample) {
+      _latency = now - _stateSince;
+      _waitingForSample = false;
+    }
+
+    if(value >= _absenceThreshold) {
+      _lowSince = now;
+      return false;
+    }
+
+    if(now - _lowSince < _absenceTimeMs) return false;
+
+    // Finger removed, wait for it with the pilot LED
+    if(!_sensor.enterProximityMode()) return false;
+    changeState(false);
+    return true;
+  }
+
+  /**
+   * Presence state
+   * @return true if a finger is present, otherwise false
+   */
+  bool present() const {
+    return _present;
+  }
+
+  /**
+   * Time spent in proximity mode
+   * @return Time in ms
+   */
+  unsigned long proximityTime() const {
+    return _proximityTime + (_present ? 0 : millis() - _stateSince);
+  }
+
+  /**
+   * Time spent in measurement mode
+   * @return Time in ms
+   */
+  unsigned long measurementTime() const {
+    return _measurementTime + (_present ? millis() - _stateSince : 0);
+  }
+
+  /**
+   * Latency of the last transition from proximity mode to the first sample
+   * @return Time in ms
+   */
+  unsigned long latency() const {
+    return _latency;
+  }
+};
+
+#endif
@@ -0,0 +1,126 @@
+/*!
+ * @file MAX3010x_ambient.h
+ */
+
+
+#ifndef _MAX3010x_AMBIENT_H
+#define _MAX3010x_AMBIENT_H
+
+#include <stdint.h>
+
+/**
+ * Ambient Light Subtraction
+ *
+ * Subtracts a dark reference slot of a multi LED stream from all other slots.
+ * The reference slot measures the ambient light only, e.g.:
+ * - MAX30105: SLOT_PILOT_* slot with the proximity LED current set to 0
+ * - MAX30101/MAX30105: Slot of an otherwise unused LED with its current set to 0
+ *
+ * The slots of a sample are measured one after another, so the ambient light is sampled at a
+ * different time than the active slots. The ambient level at the time of each slot is extrapolated
+ * linearly from the last two reference values: ambient = ref[n] + k * (ref[n] - ref[n-1]) with
+ * k = (slot - referenceSlot) * slotInterval / samplePeriod. This compensates slowly varying
+ * ambient light, flicker above half the sampling rate can not be corrected.
+ *
+ * All arithmetic is done in integers (k in Q8 format), outputs are signed.
+ */
+class MAX3010xAmbientCanceller {
+  static const uint8_t kMaxSlots = 4;   //!< Maximum number of slots
+
+  uint8_t _referenceSlot;               //!< Index of the reference slot
+  int16_t _skew[kMaxSlots];             //!< Extrapolation factors per slot (Q8)
+  int32_t _lastReference;               //!< Reference value of the previous sample
+  bool _valid;                          //!< Previous reference value available
+public:
+  /**
+   * Constructor
+   * @param referenceSlot Index of the reference slot
+   * @param slotInterval Time between two consecutive slots in us (0 disables the skew compensation)
+   * @param samplingRate Sampling rate in Hz (after on-chip averaging)
+   */
+  MAX3010xAmbientCanceller(uint8_t referenceSlot, float slotInterval = 0, float samplingRate = 100) {
+    configure(referenceSlot, slotInterval, samplingRate);
+  }
+
+  /**
+   * Configure the reference slot and the slot timing and reset the stored values
+   * @param referenceSlot Index of the reference slot
+   * @param slotInterval Time between two consecutive slots in us (0 disables the skew compensation)
+   * @param samplingRate Sampling rate in Hz (after on-chip averaging)
+   */
+  void configure(uint8_t referenceSlot, float slotInterval = 0, float samplingRate = 100) {
+    _referenceSlot = referenceSlot;
+
+    const float k = slotInterval * samplingRate * 1e-6f * 256.0f;
+    for(uint8_t slot = 0; slot < kMaxSlots; slot++) {
+      float skew = (static_cast<int8_t>(slot) - static_cast<int8_t>(referenceSlot)) * k;
+      _skew[slot] = static_cast<int16_t>(skew < 0 ? skew - 0.5f : skew + 0.5f);
+    }
+
+    reset();
+  }
+
+  /**
+   * Resets the stored values
+   */
+  void reset() {
+    _lastReference = 0;
+    _valid = false;
+  }
+
+  /**
+   * Process a single sample
+   * @param values Slot values (e.g. MAX30105Sample::slot)
+   * @param slots Number of slots
+   * @param output Ambient compensated slot values, the reference slot contains the ambient level
+   */
+  void process(const uint32_t* values, uint8_t slots, int32_t* output) {
+    if(_referenceSlot >= slots) return;
+
+    const int32_t reference = values[_referenceSlot];
+    const int32_t slope = _valid ? reference - _lastReference : 0;
+
+    for(uint8_t slot = 0; slot < slots && slot < kMaxSlots; slot++) {
+      const int32_t ambient = reference + ((slope * _skew[slot]) >> 8);
+      output[slot] = slot == _referenceSlot ? reference : static_cast<int32_t>(values[slot]) - ambient;
+    }
+
+    _lastReference = reference;
+    _valid = true;
+  }
+
+  /**
+   * Process a drained FIFO batch (MAX3010xRawData)
+   * @remarks The batch is processed slot by slot with constant coefficients in the inner loop.
+   * @param raw Raw FIFO data
+   * @param output Buffer for raw.samples * raw.slots values in the order of the raw data,
+   *               the reference slot contains the ambient level
+   */
+  template<class Raw> void process(const Raw& raw, int32_t* output) {
+    const uint8_t slots = raw.slots;
+    if(_referenceSlot >= slots || raw.samples == 0) return;
+
+    // Ambient level at the time of the reference slot
+    int32_t* reference = output + _referenceSlot;
+    for(uint8_t i = 0; i < raw.samples; i++) {
+      reference[i * slots] = raw.value(i, _referenceSlot);
+    }
+
+    for(uint8_t slot = 0; slot < slots && slot < kMaxSlots; slot++) {
+      if(slot == _referenceSlot) continue;
+
+      const int32_t skew = _skew[slot];
+      int32_t previous = _valid ? _lastReference : reference[0];
+      for(uint8_t i = 0; i < raw.samples; i++) {
+        const int32_t current = reference[i * slots];
+        output[i * slots + slot] = static_cast<int32_t>(raw.value(i, slot)) - (current + (((current - previous) * skew) >> 8));
+        previous = current;
+      }
+    }
+
+    _lastReference = reference[(raw.samples - 1) * slots];
+    _valid = true;
+  }
+};
+
+#endif
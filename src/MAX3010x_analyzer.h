@@ -0,0 +1,240 @@
+/*!
+ * @file MAX3010x_analyzer.h
+ */
+
+
+#ifndef _MAX3010x_ANALYZER_H
+#define _MAX3010x_ANALYZER_H
+
+#include <stdint.h>
+#include <math.h>
+
+#include "MAX3010x_decimator.h"
+#include "MAX3010x_signalQuality.h"
+#include "MAX3010x_spectralHeartRate.h"
+#include "MAX3010x_spo2Fixed.h"
+
+/**
+ * Heart Rate and SpO2 Analyzer
+ *
+ * Complete processing chain from raw FIFO data to heart rate, SpO2 and signal quality:
+ * - Signal quality of the red and IR channel (MAX3010xSignalQuality)
+ * - Heart rate from the IR channel, decimated to about 25 Hz (MAX3010xDecimator, MAX3010xSpectralHeartRate)
+ * - SpO2 from the AC/DC statistics of both channels, low-pass filtered at 5 Hz, with the integer lookup (MAX3010xSpO2Lookup)
+ *
+ * Results are updated at the end of each 1.5 s window, which covers at least one beat within 40 - 240 BPM.
+ * The analyzer only depends on MAX3010xRawData, so the same code runs on the device (fed by drainRaw() or poll())
+ * and on a host over recorded FIFO data (see extras/linux/batchAnalysis.cpp). Results agree up to floating point
+ * rounding: the host build disables fused multiply-adds (-ffp-contract=off), but the math libraries may still differ.
+ *
+ * Usage:
+ * @code
+ * MAX3010xAnalyzer<> analyzer(400);
+ * ...
+ * sensor.drainRaw([](const MAX3010xRawData& raw) {
+ *   analyzer.process(raw, [](const MAX3010xAnalyzer<>& result) {
+ *     if(result.usable()) Serial.println(result.bpm());
+ *   });
+ * });
+ * @endcode
+ *
+ * @tparam kWindow Window length of the heart rate estimator in decimated samples (256: 10.2 s)
+ * @tparam kTaps Filter length of the decimator (64: good attenuation up to 400 SPS)
+ */
+template<uint16_t kWindow = 256, uint8_t kTaps = 64> class MAX3010xAnalyzer {
+  static constexpr float kHeartRateRate = 25.0f;   //!< Target rate of the heart rate estimator in Hz
+  static constexpr float kResultPeriod = 1.5f;     //!< Result window in seconds
+  static constexpr float kLowPassCutoff = 5.0f;    //!< Cutoff of the low-pass filter before the AC/DC statistics in Hz
+
+  MAX3010xSignalQuality _qualityRed;          //!< Signal quality of the red channel
+  MAX3010xSignalQuality _qualityIr;           //!< Signal quality of the IR channel
+  MAX3010xDecimator<kTaps> _decimator;        //!< Decimator for the heart rate estimator
+  MAX3010xSpectralHeartRate<kWindow> _heartRate; //!< Heart rate estimator
+  MAX3010xPulseStatistic _statRed;            //!< AC/DC statistic of the red channel
+  MAX3010xPulseStatistic _statIr;             //!< AC/DC statistic of the IR channel
+  float _lowPassFactor;                       //!< Factor of the first order low-pass filter
+  float _lowPassRed;                          //!< Low-pass filtered red value (NaN before the first sample)
+  float _lowPassIr;                           //!< Low-pass filtered IR value (NaN before the first sample)
+  uint8_t _redSlot;                           //!< Slot of the red LED
+  uint8_t _irSlot;                            //!< Slot of the IR LED
+  uint16_t _windowSamples;                    //!< Result window in samples
+  uint16_t _windowCount;                      //!< Samples in the current window
+  uint32_t _windows;                          //!< Number of completed windows
+  uint16_t _ratio;                            //!< Ratio of ratios of the last window (Q10)
+  uint16_t _spo2;                             //!< SpO2 of the last window (Q8)
+  bool _usable;                               //!< Signal quality of the last window was sufficient
+
+  /**
+   * First order low-pass filter (see LowPassFilter of the SpO2 example)
+   * @param state Filtered value
+   * @param value Raw value
+   * @return Filtered value, rounded
+   */
+  uint32_t lowPass(float& state, uint32_t value) const {
+    if(isnan(state)) state = value;
+    else state += _lowPassFactor * (value - state);
+    return static_cast<uint32_t>(state + 0.5f);
+  }
+public:
+  /**
+   * Constructor
+   * @param samplingRate Sampling rate in Hz (after sample averaging)
+   * @param redSlot Slot of the red LED (0 for the MAX30101/2/5 in SpO2 mode, 1 for the MAX30100)
+   * @param irSlot Slot of the IR LED (1 for the MAX30101/2/5 in SpO2 mode, 0 for the MAX30100)
+   * @param sampleSize Size of a FIFO value in bytes (3, 2 for the MAX30100)
+   */
+  MAX3010xAnalyzer(float samplingRate, uint8_t redSlot = 0, uint8_t irSlot = 1, uint8_t sampleSize = 3) : _qualityRed(samplingRate), _qualityIr(samplingRate), _decimator(1), _heartRate(kHeartRateRate) {
+    configure(samplingRate, redSlot, irSlot, sampleSize);
+  }
+
+  /**
+   * Configure the analyzer and reset the stored values
+   * @param samplingRate Sampling rate in Hz (after sample averaging)
+   * @param redSlot Slot of the red LED
+   * @param irSlot Slot of the IR LED
+   * @param sampleSize Size of a FIFO value in bytes (3, 2 for the MAX30100)
+   */
+  void configure(float samplingRate, uint8_t redSlot = 0, uint8_t irSlot = 1, uint8_t sampleSize = 3) {
+    float factor = floorf(samplingRate / kHeartRateRate + 0.5f);
+    if(factor < 1) factor = 1;
+    if(factor > 255) factor = 255;
+
+    _qualityRed.configure(samplingRate, 3.0f, sampleSize);
+    _qualityIr.configure(samplingRate, 3.0f, sampleSize);
+    _decimator.configure(static_cast<uint8_t>(factor));
+    _heartRate.configure(samplingRate / factor);
+    _lowPassFactor = 1.0f - expf(-2.0f * static_cast<float>(M_PI) * kLowPassCutoff / samplingRate);
+    _redSlot = redSlot;
+    _irSlot = irSlot;
+    _windowSamples = static_cast<uint16_t>(samplingRate * kResultPeriod);
+    if(_windowSamples == 0) _windowSamples = 1;
+    reset();
+  }
+
+  /**
+   * Resets the stored values
+   */
+  void reset() {
+    _qualityRed.reset();
+    _qualityIr.reset();
+    _decimator.reset();
+    _heartRate.reset();
+    _statRed.reset();
+    _statIr.reset();
+    _lowPassRed = NAN;
+    _lowPassIr = NAN;
+    _windowCount = 0;
+    _windows = 0;
+    _ratio = 0;
+    _spo2 = 0;
+    _usable = false;
+  }
+
+  /**
+   * Add a sample
+   * @param red Raw value of the red LED
+   * @param ir Raw value of the IR LED
+   * @return true if a window was completed and the results were updated, otherwise false
+   */
+  bool process(uint32_t red, uint32_t ir) {
+    _qualityRed.process(red);
+    _qualityIr.process(ir);
+    _statRed.process(lowPass(_lowPassRed, red));
+    _statIr.process(lowPass(_lowPassIr, ir));
+
+    float decimated;
+    if(_decimator.process(static_cast<float>(ir), decimated)) _heartRate.process(decimated);
+
+    if(++_windowCount < _windowSamples) return false;
+    _windowCount = 0;
+    _windows++;
+
+    _usable = _qualityRed.usable() && _qualityIr.usable();
+    _ratio = MAX3010xRatio::q10(_statRed.ac(), _statRed.dc(), _statIr.ac(), _statIr.dc());
+    _spo2 = MAX3010xSpO2Lookup<>::spo2(_ratio);
+    _heartRate.estimate();
+
+    _statRed.reset();
+    _statIr.reset();
+    return true;
+  }
+
+  /**
+   * Add a drained FIFO batch (MAX3010xRawData)
+   * @param raw Raw FIFO data
+   * @param callback Function or function object accepting a const MAX3010xAnalyzer&, called for every completed window
+   */
+  template<class Raw, class Callback> void process(const Raw& raw, Callback callback) {
+    if(_redSlot >= raw.slots || _irSlot >= raw.slots) return;
+
+    for(uint8_t i = 0; i < raw.samples; i++) {
+      if(process(raw.value(i, _redSlot), raw.value(i, _irSlot))) callback(*this);
+    }
+  }
+
+  /**
+   * Number of completed windows since reset
+   * @return Number of windows
+   */
+  uint32_t windows() const {
+    return _windows;
+  }
+
+  /**
+   * Check whether the signal quality of the last window was sufficient (see MAX3010xSignalQuality::usable())
+   * @return true if the results of the last window are usable
+   */
+  bool usable() const {
+    return _usable;
+  }
+
+  /**
+   * Heart rate
+   * @return Heart rate in BPM or NaN until the estimator window is filled
+   */
+  float bpm() const {
+    return _heartRate.bpm();
+  }
+
+  /**
+   * Confidence of the heart rate
+   * @return Peak prominence between 0 and 1 (see MAX3010xSpectralHeartRate::confidence())
+   */
+  float confidence() const {
+    return _heartRate.confidence();
+  }
+
+  /**
+   * Ratio of ratios of the last window
+   * @return R in Q10 format (1024 = 1.0)
+   */
+  uint16_t ratio() const {
+    return _ratio;
+  }
+
+  /**
+   * SpO2 of the last window
+   * @return SpO2 in Q8 format (256 = 1 %)
+   */
+  uint16_t spo2() const {
+    return _spo2;
+  }
+
+  /**
+   * Signal quality of the red channel
+   * @return Signal quality
+   */
+  const MAX3010xSignalQuality& red() const {
+    return _qualityRed;
+  }
+
+  /**
+   * Signal quality of the IR channel
+   * @return Signal quality
+   */
+  const MAX3010xSignalQuality& ir() const {
+    return _qualityIr;
+  }
+};
+
+#endif
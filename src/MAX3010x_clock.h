@@ -0,0 +1,156 @@
+/*!
+ * @file MAX3010x_clock.h
+ */
+
+
+#ifndef _MAX3010x_CLOCK_H
+#define _MAX3010x_CLOCK_H
+
+#include <stdint.h>
+
+/**
+ * Sample Clock Estimator
+ *
+ * The internal oscillator of the sensor deviates from the nominal sampling rate.
+ * This estimator tracks the true sample period and the time offset between the sample counter
+ * of the sensor and the host clock using an alpha-beta filter. It is fed with observations of
+ * the number of samples produced by the sensor at a given host time, e.g. after each drain:
+ * @code
+ * clock.observe(sensor.observedMicros(), sensor.observedSamples());
+ * @endcode
+ * Afterwards timestamp() returns the corrected host time for any sample index
+ * (samplesRead() + samplesLost() + samplesDiscarded() is the index of the next sample read).
+ * Samples discarded by clearFIFO(), e.g. on a mode change, are counted, so the estimate keeps tracking.
+ * After a change of the sampling rate the estimator should be reset().
+ *
+ * All arithmetic is done relative to the last observation, so the estimator keeps its precision
+ * with single precision floats and handles the wrap-around of micros().
+ */
+class MAX3010xClockEstimator {
+  float _nominalPeriod;     //!< Nominal sample period in us
+  float _period;            //!< Estimated sample period in us
+  float _alpha;             //!< Offset gain
+  float _beta;              //!< Period gain
+  uint32_t _refSample;      //!< Sample index of the reference point
+  uint32_t _refMicros;      //!< Host time of the reference point in us
+  float _refFraction;       //!< Fractional part of the reference time in us
+  float _residual;          //!< Smoothed absolute residual in us
+  uint16_t _observations;   //!< Number of observations
+public:
+  /**
+   * Constructor
+   * @param nominalRate Nominal sampling rate in Hz (after on-chip averaging)
+   * @param alpha Offset gain of the tracking filter (0 < alpha < 1)
+   * @param beta Period gain of the tracking filter (0 < beta < alpha)
+   */
+  MAX3010xClockEstimator(float nominalRate, float alpha = 0.02f, float beta = 0.0002f) :
+    _nominalPeriod(1e6f / nominalRate),
+    _alpha(alpha),
+    _beta(beta) {
+    reset();
+  }
+
+  /**
+   * Resets the estimate to the nominal sampling rate
+   */
+  void reset() {
+    _period = _nominalPeriod;
+    _refSample = 0;
+    _refMicros = 0;
+    _refFraction = 0;
+    _residual = 0;
+    _observations = 0;
+  }
+
+  /**
+   * Add an observation
+   * @param micros Host time in us
+   * @param samples Number of samples produced by the sensor at this time
+   */
+  void observe(uint32_t micros, uint32_t samples) {
+    if(_observations == 0) {
+      _refSample = samples;
+      _refMicros = micros;
+      _refFraction = 0;
+      _observations = 1;
+      return;
+    }
+
+    int32_t dn = static_cast<int32_t>(samples - _refSample);
+    if(dn <= 0) return;
+
+    // Predict the reference point for the new sample index
+    float predicted = _refFraction + _period * dn;
+    int32_t whole = static_cast<int32_t>(predicted);
+    _refFraction = predicted - whole;
+    _refMicros += whole;
+    _refSample = samples;
+
+    float error = static_cast<int32_t>(micros - _refMicros) - _refFraction;
+
+    // Least squares gains during start-up, fixed gains afterwards
+    if(_observations < 0xFFFF) _observations++;
+    float k = _observations;
+    float alpha = 2.0f * (2.0f * k - 1.0f) / (k * (k + 1.0f));
+    float beta = 6.0f / (k * (k + 1.0f));
+    if(alpha < _alpha) alpha = _alpha;
+    if(beta < _beta) beta = _beta;
+
+    _refFraction += alpha * error;
+    _period += beta * error / dn;
+    _residual += 0.05f * ((error < 0 ? -error : error) - _residual);
+  }
+
+  /**
+   * Corrected timestamp of a sample
+   * @param sample Sample index
+   * @return Host time in us
+   */
+  uint32_t timestamp(uint32_t sample) const {
+    // Observations are made half a sample period after the last sample was produced on average
+    float offset = _refFraction + _period * (static_cast<int32_t>(sample - _refSample) + 0.5f);
+    return _refMicros + static_cast<int32_t>(offset < 0 ? offset - 0.5f : offset + 0.5f);
+  }
+
+  /**
+   * Estimated sample period
+   * @return Sample period in us
+   */
+  float period() const {
+    return _period;
+  }
+
+  /**
+   * Estimated sampling rate
+   * @return Sampling rate in Hz
+   */
+  float rate() const {
+    return 1e6f / _period;
+  }
+
+  /**
+   * Deviation of the sensor clock from the nominal sampling rate
+   * @return Deviation in ppm (positive if the sensor is faster than nominal)
+   */
+  float drift() const {
+    return (_nominalPeriod / _period - 1.0f) * 1e6f;
+  }
+
+  /**
+   * Smoothed absolute deviation of the observations from the estimate
+   * @return Residual in us
+   */
+  float residual() const {
+    return _residual;
+  }
+
+  /**
+   * Number of observations
+   * @return Number of observations
+   */
+  uint16_t observations() const {
+    return _observations;
+  }
+};
+
+#endif
@@ -0,0 +1,1089 @@
+/*!
+ * @file MAX3010x_core.cpp
+ */
+
+#include <string.h>
+
+#include "MAX3010x_core.h"
+
+/**
+ * Constructor
+ * Initializes a new sensor instance
+ *
+ * @param descriptor Chip Descriptor
+ * @param addr Sensor Address
+ * @param wire TWI bus instance
+ */
+MAX3010xBase::MAX3010xBase(const MAX3010xDescriptor& descriptor, uint8_t addr, TwoWire& wire) : _descriptor(descriptor), _addr(addr), _wireTransport(wire), _transport(_wireTransport), resolutionBits(0), nActiveSlots(0), currentMode(0), nConfiguredSlots(0), _drainBusy(false), _drainFailed(false), _pollState(POLL_STATE_IDLE), _pollTemperatureRequested(false), _pollTemperature(NAN), _samplesRead(0), _pendingOverflow(0), _observedSamples(0), _observedMicros(0), _diagnostics(), _recoveryPolicy(0, 0, false, false), _recovering(false), _backoff(0), _backoffStart(0), _configCount(0), _busClock(0), _startMicros(0), _firstSamplePending(false) {
+
+}
+
+/**
+ * Constructor
+ * Initializes a new sensor instance using a custom transport
+ *
+ * @param descriptor Chip Descriptor
+ * @param addr Sensor Address
+ * @param transport Bus transport
+ */
+MAX3010xBase::MAX3010xBase(const MAX3010xDescriptor& descriptor, uint8_t addr, MAX3010xTransport& transport) : _descriptor(descriptor), _addr(addr), _wireTransport(), _transport(transport), resolutionBits(0), nActiveSlots(0), currentMode(0), nConfiguredSlots(0), _drainBusy(false), _drainFailed(false), _pollState(POLL_STATE_IDLE), _pollTemperatureRequested(false), _pollTemperature(NAN), _samplesRead(0), _pendingOverflow(0), _observedSamples(0), _observedMicros(0), _diagnostics(), _recoveryPolicy(0, 0, false, false), _recovering(false), _backoff(0), _backoffStart(0), _configCount(0), _busClock(0), _startMicros(0), _firstSamplePending(false) {
+
+}
+
+/**
+ * Number of samples pending in the FIFO
+ * @param fifo FIFO Registers
+ * @return Number of samples
+ */
+uint8_t MAX3010xBase::pendingSamples(const FIFORegisters& fifo) {
+  if(fifo.read == fifo.write) {
+    // FIFO is completely full
+    if(fifo.overflow) {
+      return _descriptor.fifoSize;
+    }
+  }
+  return (_descriptor.fifoSize + fifo.write - fifo.read) % _descriptor.fifoSize;
+}
+
+/**
+ * Cache a written register for re-initialization
+ * @param reg Register
+ * @param value Value
+ */
+void MAX3010xBase::cacheRegister(uint8_t reg, uint8_t value) {
+  // FIFO state and triggers are not part of the configuration
+  if(reg >= _descriptor.fifoBase && reg <= _descriptor.fifoBase + FIFO_DATA_OFFSET) return;
+  if(reg == _descriptor.modeReg) value &= ~(1 << _descriptor.resetBit);
+  if(reg == _descriptor.tempConfigReg) {
+    if(reg != _descriptor.modeReg) return;
+    value &= ~(1 << _descriptor.tempConfigBit);
+  }
+
+  for(uint8_t i = 0; i < _configCount; i++) {
+    if(_configRegs[i] == reg) {
+      _configValues[i] = value;
+      return;
+    }
+  }
+
+  if(_configCount < MAX3010x_CONFIG_CACHE_SIZE) {
+    _configRegs[_configCount] = reg;
+    _configValues[_configCount] = value;
+    _configCount++;
+  }
+}
+
+/**
+ * Reset the sensor and restore the cached configuration
+ * @return true if successful, otherwise false
+ */
+bool MAX3010xBase::reinitialize() {
+  // Bypass the cache, it has to keep the configuration
+  uint8_t value = 1 << _descriptor.resetBit;
+  if(!transfer(true, _descriptor.modeReg, 1, &value)) return false;
+  if(!waitBit(_descriptor.modeReg, _descriptor.resetBit, false, _recoveryPolicy.resetTimeoutMs)) return false;
+  _diagnostics.resets++;
+
+  for(uint8_t i = 0; i < _configCount; i++) {
+    if(!transfer(true, _configRegs[i], 1, &_configValues[i])) return false;
+  }
+
+  // The reset discarded the samples, only the FIFO pointers are cleared (see clearFIFO())
+  uint8_t pointers[FIFO_DATA_OFFSET] = { 0 };
+  return transfer(true, _descriptor.fifoBase + FIFO_WR_PTR_OFFSET, FIFO_DATA_OFFSET, pointers);
+}
+
+/**
+ * Single transfer attempt
+ * @param write true for a write, false for a read
+ * @param reg Register
+ * @param count Number of bytes
+ * @param buffer Buffer
+ * @return true if successful, otherwise false
+ */
+bool MAX3010xBase::attemptTransfer(bool write, uint8_t reg, uint8_t count, uint8_t* buffer) {
+  if(write ? _transport.write(_addr, reg, count, buffer) : _transport.read(_addr, reg, count, buffer)) return true;
+  _diagnostics.recordBusError(_transport.lastError());
+  return false;
+}
+
+/**
+ * Transfer with bus error recovery (see MAX3010xRecoveryPolicy)
+ * @param write true for a write, false for a read
+ * @param reg Register
+ * @param count Number of bytes
+ * @param buffer Buffer
+ * @return true if successful, otherwise false
+ */
+bool MAX3010xBase::transfer(bool write, uint8_t reg, uint8_t count, uint8_t* buffer) {
+  if(_backoff > 0) {
+    if(millis() - _backoffStart < _backoff) return false;
+  }
+
+  if(attemptTransfer(write, reg, count, buffer)) {
+    _backoff = 0;
+    return true;
+  }
+
+  // Reading the FIFO data register is not repeatable, see readFIFOData()
+  if(_recovering || (!write && reg == _descriptor.fifoBase + FIFO_DATA_OFFSET)) return false;
+  if(_recoveryPolicy.retries == 0 && !_recoveryPolicy.busClear && !_recoveryPolicy.reinit) return false;
+
+  _recovering = true;
+  const unsigned long start = micros();
+  bool success = false;
+
+  for(uint8_t i = 0; !success && i < _recoveryPolicy.retries && micros() - start < _recoveryPolicy.budgetUs; i++) {
+    delayMicroseconds(_recoveryPolicy.retryDelayUs);
+    success = attemptTransfer(write, reg, count, buffer);
+  }
+
+  // Transports without bus clear support (e.g. MAX3010xWireTransport without pins) return false right away
+  if(!success && _recoveryPolicy.busClear && micros() - start < _recoveryPolicy.budgetUs && _transport.recoverBus()) {
+    _diagnostics.busClears++;
+    success = attemptTransfer(write, reg, count, buffer);
+  }
+
+  if(!success && _recoveryPolicy.reinit && micros() - start < _recoveryPolicy.budgetUs) {
+    _diagnostics.reinits++;
+    success = reinitialize() && attemptTransfer(write, reg, count, buffer);
+  }
+
+  _recovering = false;
+  _diagnostics.recordRecovery(success, micros() - start);
+
+  if(success) {
+    _backoff = 0;
+  }
+  else {
+    // Exponential back-off
+    _backoff = _backoff == 0 ? _recoveryPolicy.backoffMs : _backoff * 2;
+    if(_backoff > _recoveryPolicy.maxBackoffMs) _backoff = _recoveryPolicy.maxBackoffMs;
+    _backoffStart = millis();
+  }
+
+  return success;
+}
+
+/**
+ * Read FIFO Registers
+ * @remarks Records the number of samples produced by the sensor and the time of the read
+ * @param fifo FIFO Registers
+ * @return true if successful, otherwise false
+ */
+bool MAX3010xBase::readFIFORegisters(FIFORegisters& fifo) {
+  unsigned long now = micros();
+  if(!readBlock(_descriptor.fifoBase, sizeof(FIFORegisters), reinterpret_cast<uint8_t*>(&fifo))) return false;
+
+  // The overflow counter is reset once a sample is read, it is accounted in readFIFOData()
+  _pendingOverflow = fifo.overflow;
+  _observedSamples = _samplesRead + _diagnostics.samplesLost + _diagnostics.samplesDiscarded + _pendingOverflow + pendingSamples(fifo);
+  _observedMicros = now;
+  return true;
+}
+
+/**
+ * Completion handler for asynchronous drains
+ * @param context Sensor instance
+ * @param success true if the transfer was successful, otherwise false
+ */
+void MAX3010xBase::drainCompleted(void* context, bool success) {
+  MAX3010xBase* sensor = static_cast<MAX3010xBase*>(context);
+
+  if(success) {
+    sensor->_samplesRead += sensor->_drainData.samples;
+    sensor->_diagnostics.samplesLost += sensor->_pendingOverflow;
+    sensor->_diagnostics.recordDrain(micros() - sensor->_observedMicros, sensor->_drainData.samples);
+    sensor->_pendingOverflow = 0;
+  }
+  else {
+    sensor->_diagnostics.recordBusError(sensor->_transport.lastError());
+    sensor->_drainFailed = true;
+    sensor->_drainData.samples = 0;
+  }
+  sensor->_drainBusy = false;
+  sensor->_drainCallback(sensor->_drainContext, sensor->_drainData);
+}
+
+/**
+ * Verify bus communication by reading the part ID
+ * @return true if the part ID was read correctly in all attempts, otherwise false
+ */
+bool MAX3010xBase::verifyBus() {
+  for(uint8_t i = 0; i < 3; i++) {
+    uint8_t partId;
+    if(!attemptTransfer(false, PART_ID_REG, 1, &partId)) return false;
+    if(partId != _descriptor.partId) {
+      _diagnostics.partIdMismatches++;
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Read Block
+ * @param reg Register
+ * @param count Number of bytes to read
+ * @param buffer Buffer for values
+ * @return true if successful, otherwise false
+ */
+bool MAX3010xBase::readBlock(uint8_t reg, uint8_t count, uint8_t* buffer) {
+  return transfer(false, reg, count, buffer);
+}
+
+/**
+ * Read Byte
+ * @param reg Register
+ * @param value Reference to uint8_t variable to store the result in
+ * @return true if successful, otherwise false
+ */
+bool MAX3010xBase::readByte(uint8_t reg, uint8_t& value) {
+  return readBlock(reg, 1, &value);
+}
+
+/**
+ * Write Block
+ * @param reg Register
+ * @param count Number of bytes to write
+ * @param buffer Buffer with values
+ * @return true if successful, otherwise false
+ */
+bool MAX3010xBase::writeBlock(uint8_t reg, uint8_t count, uint8_t* buffer) {
+  if(!transfer(true, reg, count, buffer)) return false;
+
+  for(uint8_t i = 0; i < count; i++) {
+    cacheRegister(reg + i, buffer[i]);
+  }
+  return true;
+}
+
+/**
+ * Write Byte
+ * @param reg Register
+ * @param value Value
+ * @return true if successful, otherwise false
+ */
+bool MAX3010xBase::writeByte(uint8_t reg, uint8_t value) {
+  return writeBlock(reg, 1, &value);
+}
+
+/**
+ * Read Bit
+ * @param reg Register
+ * @param bit Bit Index
+ * @param value Reference to bool variable to store the result in
+ * @return true if successful, otherwise false
+ */
+bool MAX3010xBase::readBit(uint8_t reg, uint8_t bit, bool& value) {
+  uint8_t byte;
+
+  if(!readByte(reg, byte)) return false;
+  value = (byte >> bit) & 0x1;
+
+  return true;
+}
+
+/**
+ * Wait for Bit
+ * @remarks The register is polled with an exponential back-off (see MAX3010xWaitBackoff)
+ * @param reg Register
+ * @param bit Bit Index
+ * @param expectedState Expected State
+ * @param timeout Timeout in ms
+ * @return true if successful, otherwise false
+ */
+bool MAX3010xBase::waitBit(uint8_t reg, uint8_t bit, bool expectedState, int timeout) {
+  bool bitValue;
+  unsigned long startTime = micros();
+  unsigned int backoff = MAX3010x_WAIT_BACKOFF_MIN_US;
+  while (true) {
+
+    // Check for bit
+    if(!readBit(reg, bit, bitValue)) {
+      return false;
+    }
+    if(bitValue == expectedState) {
+      return true;
+    }
+
+    // Timeout
+    if(micros() - startTime > static_cast<unsigned long>(timeout) * 1000) {
+      return false;
+    }
+
+    // A reset completes within microseconds, a temperature conversion takes milliseconds
+    delayMicroseconds(backoff);
+    backoff = MAX3010xWaitBackoff::next(backoff);
+  }
+}
+
+/**
+ * Set Bit
+ * @param reg Register
+ * @param bit Bit Index
+ * @param value Value
+ * @return true if successful, otherwise false
+ */
+bool MAX3010xBase::setBit(uint8_t reg, uint8_t bit, bool value) {
+  uint8_t byte;
+
+  if(!readByte(reg, byte)) return false;
+
+  byte &= ~(1<<bit);
+
+  if(value) {
+    byte |= 1<<bit;
+  }
+
+  return writeByte(reg, byte);
+}
+
+/**
+ * Read consecutive samples from the FIFO data register
+ * @param readPointer FIFO read pointer before the read
+ * @param samples Number of samples
+ * @param sampleBytes Bytes per sample
+ * @param buffer Buffer for the raw data
+ * @return true if successful, otherwise false
+ */
+bool MAX3010xBase::readFIFOData(uint8_t readPointer, uint8_t samples, uint8_t sampleBytes, uint8_t* buffer) {
+  uint8_t attempt = 0;
+  while(!readBlock(_descriptor.fifoBase + FIFO_DATA_OFFSET, samples * sampleBytes, buffer)) {
+    const uint32_t reinits = _diagnostics.reinits;
+
+    // Restore read pointer in case of an error to allow a retry
+    if(!writeByte(_descriptor.fifoBase + FIFO_RD_PTR_OFFSET, readPointer)) return false;
+    _diagnostics.readPointerRestores++;
+
+    // The FIFO was cleared by a re-initialization, the read pointer is no longer valid
+    if(_diagnostics.reinits != reinits) {
+      clearFIFO();
+      return false;
+    }
+
+    if(attempt++ >= _recoveryPolicy.retries) return false;
+    delayMicroseconds(_recoveryPolicy.retryDelayUs);
+  }
+
+  if(_firstSamplePending) {
+    _firstSamplePending = false;
+    _diagnostics.firstSampleMicros = micros() - _startMicros;
+  }
+
+  _samplesRead += samples;
+  _diagnostics.samplesLost += _pendingOverflow;
+  _diagnostics.recordDrain(micros() - _observedMicros, samples);
+  _pendingOverflow = 0;
+  return true;
+}
+
+/**
+ * Set Field
+ * @param reg Register
+ * @param bit Bit Position
+ * @param mask Bit Mask (unshifted)
+ * @param value Unshifted field value
+ * @return true if successful, otherwise false
+ */
+bool MAX3010xBase::setField(uint8_t reg, uint8_t bit, uint8_t mask, uint8_t value) {
+  uint8_t byte;
+
+  if(value & (~ mask)) return false;
+  if(!readByte(reg, byte)) return false;
+
+  byte &= ~(mask << bit);
+  byte |= value << bit;
+
+  return writeByte(reg, byte);
+}
+
+/**
+ * Set Mode (internal)
+ * @param mode Mode
+ * @return true if successful, otherwise false
+ */
+bool MAX3010xBase::setModeInternal(uint8_t mode) {
+  uint8_t value;
+
+  if(mode & (~ MODE_MASK)) return false;
+  if(!readByte(_descriptor.modeReg, value)) return false;
+
+  value &= ~ MODE_MASK;
+  value |= mode;
+
+  if(!writeByte(_descriptor.modeReg, value)) return false;
+  currentMode = mode;
+  return clearFIFO();
+}
+
+/**
+ * Initializes the I2C transport with the fastest working bus clock
+ * @param maxClock Maximum I2C clock in Hz
+ * @param minClock Fallback I2C clock in Hz
+ * @return true if a clock was verified or the transport can't set the clock, false if the verification failed at every clock
+ */
+bool MAX3010xBase::beginBus(uint32_t maxClock, uint32_t minClock) {
+  _transport.begin();
+  _busClock = 0;
+
+  if(maxClock > BUS_CLOCK_FAST) maxClock = BUS_CLOCK_FAST;
+  if(minClock > maxClock) minClock = maxClock;
+
+  if(_transport.setClock(maxClock)) {
+    _busClock = maxClock;
+    if(verifyBus()) return true;
+  }
+  if(minClock != maxClock && _transport.setClock(minClock)) {
+    _busClock = minClock;
+    return verifyBus();
+  }
+
+  // Platform default clock, the communication is checked by the reset
+  return _busClock == 0;
+}
+
+/**
+ * Resets the sensor, identifies the part and enables the temperature interrupt
+ * @remarks The default configuration is applied by MAX3010x::reset()
+ * @param enableTemperatureInterrupt Enable the temperature interrupt (not needed if a saved configuration is restored)
+ * @return true if successful, otherwise false
+ */
+bool MAX3010xBase::resetSensor(bool enableTemperatureInterrupt) {
+
+  // Reset, the remaining mode bits are cleared by the reset anyway
+  if(!writeByte(_descriptor.modeReg, 1 << _descriptor.resetBit)) return false;
+  if(!waitBit(_descriptor.modeReg, _descriptor.resetBit, false)) return false;
+  resetCompleted();
+
+  if(!identifySensor()) return false;
+  if(!enableTemperatureInterrupt) return true;
+
+  // Enable Temperature Interrupt
+  return enableInterrupt(_descriptor.tempReady);
+}
+
+/**
+ * Forgets the state cleared by a sensor reset
+ * @remarks The sensor is back at its power-on defaults: no mode and resolution configured
+ */
+void MAX3010xBase::resetCompleted() {
+  _diagnostics.resets++;
+  _configCount = 0;
+  nActiveSlots = _descriptor.resetActiveSlots;
+  resolutionBits = 0;
+  currentMode = 0;
+  nConfiguredSlots = 0;
+}
+
+/**
+ * Identifies the part
+ * @return true if the part ID matches, otherwise false
+ */
+bool MAX3010xBase::identifySensor() {
+  uint8_t partId;
+  if(!readByte(PART_ID_REG, partId)) return false;
+  if(partId != _descriptor.partId) {
+    _diagnostics.partIdMismatches++;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Prepares the sensor for the first configuration after startup
+ * @remarks
+ * A sensor that has just been powered up (power ready flag set) is already in its reset state,
+ * the software reset is skipped then. The temperature interrupt is not enabled, the configuration
+ * applied afterwards sets all interrupt enables.
+ * @return true if successful, otherwise false
+ */
+bool MAX3010xBase::startSensor() {
+  bool powerReady;
+  if(!readBit(MAX3010xInterruptDescriptor::stReg(_descriptor.powerReady), MAX3010xInterruptDescriptor::stBit(_descriptor.powerReady), powerReady)) return false;
+  if(!powerReady) return resetSensor(false);
+
+  _configCount = 0;
+  return identifySensor();
+}
+
+/**
+ * Starts the startup time measurement of reset() and begin()
+ */
+void MAX3010xBase::beginStartup() {
+  _startMicros = micros();
+  _firstSamplePending = true;
+  _diagnostics.firstSampleMicros = 0;
+}
+
+/**
+ * Finishes the startup time measurement
+ * @param success Result of the startup
+ * @return success
+ */
+bool MAX3010xBase::endStartup(bool success) {
+  if(success) _diagnostics.startupMicros = micros() - _startMicros;
+  return success;
+}
+
+/**
+ * Read the data of a single sample from the FIFO
+ * @param data Buffer for the raw data of one sample
+ * @param timeout Timeout in ms to wait for a sample (0: wait until a sample is available)
+ * @return true if successful, otherwise false
+ */
+bool MAX3010xBase::readSampleData(uint8_t* data, int timeout) {
+  unsigned long startTime = millis();
+
+  FIFORegisters fifo;
+
+  // Check if there is any data
+  do {
+    if(!readFIFORegisters(fifo)) return false;
+
+    if(fifo.overflow != 0) break;
+    if(timeout > 0 && millis()-startTime >= timeout) return false;
+  } while(fifo.write == fifo.read);
+
+  return readFIFOData(fifo.read, 1, _descriptor.sampleSize * nActiveSlots, data);
+}
+
+/**
+* Configured bus clock
+* @return I2C clock in Hz or 0 if the platform default is used
+*/
+uint32_t MAX3010xBase::busClock() {
+  return _busClock;
+}
+
+/**
+* Enable Interrupt
+* @param interrupt Interrupt
+* @return true if successful, otherwise false
+*/
+bool MAX3010xBase::enableInterrupt(MAX3010xInterrupt interrupt) {
+  if(!MAX3010xInterruptDescriptor::hasCfg(interrupt)) return false;
+  return setBit(MAX3010xInterruptDescriptor::cfgReg(interrupt), MAX3010xInterruptDescriptor::cfgBit(interrupt), true);
+}
+
+/**
+* Disable Interrupt
+* @param interrupt Interrupt
+* @return true if successful, otherwise false
+* @remarks If you disable the temperature interrupt the readTemperature() method will no longer work
+*/
+bool MAX3010xBase::disableInterrupt(MAX3010xInterrupt interrupt) {
+  if(!MAX3010xInterruptDescriptor::hasCfg(interrupt)) return false;
+  return setBit(MAX3010xInterruptDescriptor::cfgReg(interrupt), MAX3010xInterruptDescriptor::cfgBit(interrupt), false);
+}
+
+/**
+* Check for Interrupt Flag
+* @param interrupt Interrupt
+* @return true if flag is set, otherwise false
+*/
+bool MAX3010xBase::checkInterruptFlag(MAX3010xInterrupt interrupt) {
+  bool value;
+  if(!readBit(MAX3010xInterruptDescriptor::stReg(interrupt), MAX3010xInterruptDescriptor::stBit(interrupt), value)) return false;
+  return value;
+}
+
+/**
+* Check for Interrupt Flag
+* @param interrupt Interrupt
+* @param timeout Timeout in ms
+* @return true if flag is set, otherwise false
+*/
+bool MAX3010xBase::waitForInterrupt(MAX3010xInterrupt interrupt, int timeout) {
+  return waitBit(MAX3010xInterruptDescriptor::stReg(interrupt), MAX3010xInterruptDescriptor::stBit(interrupt), true, timeout);
+}
+
+/**
+* Reads the Part Id
+* @return Part Id or 0xFF on failure
+*/
+uint8_t MAX3010xBase::readPartId() {
+  uint8_t partId;
+  if(!readByte(PART_ID_REG, partId)) return 0xFF;
+  return partId;
+}
+
+/**
+* Reads the Revision Id
+* @return Revision Id or 0xFF on failure
+*/
+uint8_t MAX3010xBase::readRevisionId() {
+  uint8_t revisionId;
+  if(!readByte(REV_ID_REG, revisionId)) return 0xFF;
+  return revisionId;
+}
+
+/**
+* Put the sensor in power down mode
+* @return true if successful, otherwise false
+*/
+bool MAX3010xBase::shutdown() {
+  return setBit(_descriptor.modeReg, _descriptor.shutdownBit, true);
+}
+
+/**
+* Wake up the sensor from power down mode
+* @return true if successful, otherwise false
+*/
+bool MAX3010xBase::wakeUp() {
+  return setBit(_descriptor.modeReg, _descriptor.shutdownBit, false);
+}
+
+/**
+* Reads the current sensor temperature
+* @remarks
+* This function will trigger the temperature interrupt once the conversion is finished.
+* Triggering this interrupt is necessary for this method. If you use the interrupt pin
+* of the MAX3010x in your application please be aware of this fact.
+* @return Temperature in °C or NaN
+*/
+float MAX3010xBase::readTemperature() {
+  uint8_t tInt;
+  uint8_t tFrac;
+
+  if(!setBit(_descriptor.tempConfigReg, _descriptor.tempConfigBit, true)) return NAN;
+  if(!waitForInterrupt(_descriptor.tempReady)) return NAN;
+  if(!readByte(_descriptor.tintReg, tInt) || !readByte(_descriptor.tfracReg, tFrac)) return NAN;
+
+  return static_cast<int8_t>(tInt) + 0.0625f * tFrac;
+}
+
+/**
+* Reads the number of available samples
+* @return Number of available samples or 0 on failure
+*/
+uint8_t MAX3010xBase::available() {
+  FIFORegisters fifo;
+  if(!readFIFORegisters(fifo)) return 0;
+  return pendingSamples(fifo);
+}
+
+/**
+* Number of active slots per sample
+* @return Number of active slots
+*/
+uint8_t MAX3010xBase::activeSlots() {
+  return nActiveSlots;
+}
+
+/**
+* Reads all available samples (up to maxSamples) from the FIFO in burst reads
+* @remarks
+* The raw FIFO bytes are copied to the buffer without decoding:
+* Each sample consists of activeSlots() values with a size of 3 bytes (2 bytes for the MAX30100) each.
+* Burst reads are split to fit into MAX3010x_I2C_BUFFER_SIZE.
+* @param data Buffer for at least maxSamples samples
+* @param maxSamples Maximum number of samples to read
+* @return Number of samples read
+*/
+uint8_t MAX3010xBase::readSamples(uint8_t* data, uint8_t maxSamples) {
+  const uint8_t sampleBytes = _descriptor.sampleSize * nActiveSlots;
+  if(sampleBytes == 0) return 0;
+
+  FIFORegisters fifo;
+  if(!readFIFORegisters(fifo)) return 0;
+
+  uint8_t count = pendingSamples(fifo);
+  if(count > maxSamples) count = maxSamples;
+
+  const uint8_t chunkSamples = MAX3010x_I2C_BUFFER_SIZE / sampleBytes;
+  uint8_t samplesRead = 0;
+  while(samplesRead < count) {
+    uint8_t chunk = count - samplesRead;
+    if(chunk > chunkSamples) chunk = chunkSamples;
+
+    if(!readFIFOData((fifo.read + samplesRead) % _descriptor.fifoSize, chunk, sampleBytes, data + samplesRead * sampleBytes)) break;
+    samplesRead += chunk;
+  }
+
+  return samplesRead;
+}
+
+/**
+* Reads the number lost samples due to FIFO overflow
+* @return Number of lost samples or 0xFF on failure
+*/
+uint8_t MAX3010xBase::readOverflowCounter() {
+  uint8_t overflowCounter;
+  if(!readByte(_descriptor.fifoBase + FIFO_OVF_CNT_OFFSET, overflowCounter)) return 0xFF;
+  return overflowCounter;
+}
+
+/**
+* Number of samples read from the FIFO since the start
+* @remarks The index of the next sample read is samplesRead() + samplesLost() + samplesDiscarded()
+* @return Number of samples
+*/
+uint32_t MAX3010xBase::samplesRead() {
+  return _samplesRead;
+}
+
+/**
+* Number of samples lost due to FIFO overflows since the start
+* @return Number of samples
+*/
+uint32_t MAX3010xBase::samplesLost() {
+  return _diagnostics.samplesLost;
+}
+
+/**
+* Number of samples discarded by clearFIFO() since the start
+* @return Number of samples
+*/
+uint32_t MAX3010xBase::samplesDiscarded() {
+  return _diagnostics.samplesDiscarded;
+}
+
+/**
+* Number of samples produced by the sensor at the last FIFO pointer read
+* @remarks Together with observedMicros() this can be used to estimate the sensor's sample clock (see MAX3010xClockEstimator)
+* @return Number of samples
+*/
+uint32_t MAX3010xBase::observedSamples() {
+  return _observedSamples;
+}
+
+/**
+* Time of the last FIFO pointer read
+* @return Time in us (micros())
+*/
+unsigned long MAX3010xBase::observedMicros() {
+  return _observedMicros;
+}
+
+/**
+* Driver Diagnostics
+* @return Diagnostics counters and histograms
+*/
+const MAX3010xDiagnostics& MAX3010xBase::diagnostics() {
+  return _diagnostics;
+}
+
+/**
+* Set the bus error recovery policy
+* @remarks
+* Recovery is disabled by default. With recovery enabled, a failing transfer can block up to
+* MAX3010xRecoveryPolicy::worstCaseMicros(), this also applies to poll().
+* The configuration restored by a re-initialization consists of all registers written since the start.
+* @param policy Recovery Policy
+*/
+void MAX3010xBase::setRecoveryPolicy(const MAX3010xRecoveryPolicy& policy) {
+  _recoveryPolicy = policy;
+  _backoff = 0;
+}
+
+/**
+* Time since the last successful FIFO data read
+* @return Time in ms (time since start if no sample was read yet)
+*/
+unsigned long MAX3010xBase::timeSinceLastSample() {
+  return millis() - _diagnostics.lastSampleMillis;
+}
+
+/**
+* Clears the FIFO
+* @remarks
+* While samples are produced the pending samples are counted as discarded first
+* (see MAX3010xDiagnostics::samplesDiscarded), so sample indices and observedSamples() keep counting
+* the samples produced by the sensor. Samples produced between that read and the clear are not counted.
+* The count costs one FIFO pointer read, so setMode() and every multi-LED slot reconfiguration perform one more transfer.
+* @return true if successful, otherwise false
+*/
+bool MAX3010xBase::clearFIFO() {
+  if(nActiveSlots != 0) {
+    FIFORegisters fifo;
+    if(!readFIFORegisters(fifo)) return false;
+    _diagnostics.samplesDiscarded += _pendingOverflow + pendingSamples(fifo);
+    _pendingOverflow = 0;
+  }
+
+  // Write pointer, overflow counter and read pointer in a single block write
+  uint8_t pointers[FIFO_DATA_OFFSET] = { 0 };
+  return writeBlock(_descriptor.fifoBase + FIFO_WR_PTR_OFFSET, FIFO_DATA_OFFSET, pointers);
+}
+
+/**
+* Saves the configuration of the sensor
+* @remarks
+* The configuration registers are read in a single block read, the interrupt enable registers
+* (and the proximity threshold of the MAX30105) in one more read each.
+* Reserved registers within the range are saved as read.
+* @param configuration Snapshot to fill
+* @return true if successful, otherwise false
+*/
+bool MAX3010xBase::saveConfiguration(MAX3010xConfiguration& configuration) {
+  configuration.partId = 0;
+  if(!readBlock(_descriptor.configReg, _descriptor.configSize, configuration.registers)) return false;
+  if(!readBlock(_descriptor.intEnableReg, _descriptor.intEnableSize, configuration.interrupts)) return false;
+
+  configuration.proximityThreshold = 0;
+  if(_descriptor.proxThresholdReg != 0 && !readByte(_descriptor.proxThresholdReg, configuration.proximityThreshold)) return false;
+
+  // Triggers are not part of the configuration
+  uint8_t& mode = configuration.registers[_descriptor.modeReg - _descriptor.configReg];
+  mode &= ~(1 << _descriptor.resetBit);
+  if(_descriptor.tempConfigReg == _descriptor.modeReg) mode &= ~(1 << _descriptor.tempConfigBit);
+
+  configuration.activeSlots = nActiveSlots;
+  configuration.configuredSlots = nConfiguredSlots;
+  configuration.resolutionBits = resolutionBits;
+  configuration.partId = _descriptor.partId;
+  return true;
+}
+
+/**
+* Restores a configuration saved by saveConfiguration()
+* @remarks
+* The registers are written in one block write for the configuration range and one for the interrupt
+* enable registers (plus the proximity threshold of the MAX30105), read back for verification and the FIFO is cleared.
+* The restored registers are also used for the re-initialization after bus errors.
+* @param configuration Snapshot
+* @return true if successful and verified, otherwise false
+*/
+bool MAX3010xBase::restoreConfiguration(const MAX3010xConfiguration& configuration) {
+  if(configuration.partId != _descriptor.partId) return false;
+
+  uint8_t buffer[MAX3010xConfiguration::MAX_CONFIG_SIZE];
+
+  memcpy(buffer, configuration.registers, _descriptor.configSize);
+  if(!writeBlock(_descriptor.configReg, _descriptor.configSize, buffer)) return false;
+  memcpy(buffer, configuration.interrupts, _descriptor.intEnableSize);
+  if(!writeBlock(_descriptor.intEnableReg, _descriptor.intEnableSize, buffer)) return false;
+  if(_descriptor.proxThresholdReg != 0 && !writeByte(_descriptor.proxThresholdReg, configuration.proximityThreshold)) return false;
+
+  // Verify
+  if(!readBlock(_descriptor.configReg, _descriptor.configSize, buffer)) return false;
+  if(memcmp(buffer, configuration.registers, _descriptor.configSize) != 0) return false;
+  if(!readBlock(_descriptor.intEnableReg, _descriptor.intEnableSize, buffer)) return false;
+  if(memcmp(buffer, configuration.interrupts, _descriptor.intEnableSize) != 0) return false;
+  if(_descriptor.proxThresholdReg != 0) {
+    if(!readByte(_descriptor.proxThresholdReg, buffer[0]) || buffer[0] != configuration.proximityThreshold) return false;
+  }
+
+  nActiveSlots = configuration.activeSlots;
+  resolutionBits = configuration.resolutionBits;
+  currentMode = configuration.registers[_descriptor.modeReg - _descriptor.configReg] & MODE_MASK;
+  nConfiguredSlots = configuration.configuredSlots;
+
+  return clearFIFO();
+}
+
+/**
+* Starts an asynchronous FIFO drain
+* @remarks
+* The FIFO pointers are read synchronously, the sample data is read with MAX3010xTransport::readAsync().
+* With a DMA capable transport this function returns while the transfer is in progress and the callback
+* is called on completion, possibly from interrupt context. The default Wire transport completes the
+* transfer before returning. At most one drain can be pending per sensor.
+* @param buffer Buffer for the raw data, must stay valid until completion
+* @param size Buffer size in bytes
+* @param callback Completion callback
+* @param context User context passed to the callback
+* @return Number of samples requested or 0 if no samples are available, a drain is pending or on failure
+*/
+uint8_t MAX3010xBase::startDrain(uint8_t* buffer, uint8_t size, MAX3010xDrainCallback callback, void* context) {
+  if(_drainBusy) return 0;
+
+  // Restore read pointer after a failed transfer to allow a retry
+  if(_drainFailed) {
+    if(!writeByte(_descriptor.fifoBase + FIFO_RD_PTR_OFFSET, _drainReadPointer)) return 0;
+    _diagnostics.readPointerRestores++;
+    _drainFailed = false;
+  }
+
+  const uint8_t sampleBytes = _descriptor.sampleSize * nActiveSlots;
+  if(sampleBytes == 0) return 0;
+
+  FIFORegisters fifo;
+  if(!readFIFORegisters(fifo)) return 0;
+
+  uint8_t count = pendingSamples(fifo);
+  uint8_t maxBytes = _transport.maxTransferSize() < size ? _transport.maxTransferSize() : size;
+  if(count > maxBytes / sampleBytes) count = maxBytes / sampleBytes;
+  if(count == 0) return 0;
+
+  _drainData.data = buffer;
+  _drainData.samples = count;
+  _drainData.slots = nActiveSlots;
+  _drainData.sampleSize = _descriptor.sampleSize;
+  _drainData.resolution = resolutionBits;
+  _drainCallback = callback;
+  _drainContext = context;
+  _drainReadPointer = fifo.read;
+  _drainBusy = true;
+
+  if(!_transport.readAsync(_addr, _descriptor.fifoBase + FIFO_DATA_OFFSET, count * sampleBytes, buffer, drainCompleted, this)) {
+    _drainBusy = false;
+    return 0;
+  }
+
+  return count;
+}
+
+/**
+* Check for a pending asynchronous drain
+* @return true if a drain started with startDrain() is still in progress
+*/
+bool MAX3010xBase::drainPending() {
+  return _drainBusy;
+}
+
+/**
+* Requests a sensor reset to be performed by poll()
+* @remarks
+* Unlike reset() the default configuration is not applied, the sensor is left without a mode.
+* poll() returns POLL_RESET once the reset is finished, POLL_ERROR if it failed.
+* A failed reset or temperature measurement is abandoned, request it again to retry.
+*/
+void MAX3010xBase::requestReset() {
+  _pollState = POLL_STATE_RESET_WRITE;
+}
+
+/**
+* Requests a temperature measurement to be performed by poll()
+* @remarks
+* poll() returns POLL_TEMPERATURE once the measurement is finished.
+* The temperature interrupt needs to be enabled, as it is after reset().
+*/
+void MAX3010xBase::requestTemperature() {
+  _pollTemperatureRequested = true;
+}
+
+/**
+* Temperature measured by poll()
+* @return Temperature in °C or NaN
+*/
+float MAX3010xBase::polledTemperature() {
+  return _pollTemperature;
+}
+
+/**
+* Non-blocking driver step (see poll())
+* @param raw Raw data, filled if POLL_SAMPLES is returned
+* @param buffer Buffer for MAX3010x_I2C_BUFFER_SIZE bytes of raw data
+* @param timeout Timeout in ms for reset and temperature measurements
+* @return Poll status
+*/
+MAX3010xBase::PollStatus MAX3010xBase::pollStep(MAX3010xRawData& raw, uint8_t* buffer, unsigned int timeout) {
+  switch(_pollState) {
+    case POLL_STATE_RESET_WRITE:
+      if(!writeByte(_descriptor.modeReg, 1 << _descriptor.resetBit)) {
+        _pollState = POLL_STATE_IDLE;
+        return POLL_ERROR;
+      }
+      _pollStart = millis();
+      _pollState = POLL_STATE_RESET_WAIT;
+      return POLL_BUSY;
+
+    case POLL_STATE_RESET_WAIT:
+      if(!readByte(_descriptor.modeReg, _pollValue)) {
+        _pollState = POLL_STATE_IDLE;
+        return POLL_ERROR;
+      }
+      if(_pollValue & (1 << _descriptor.resetBit)) {
+        if(millis() - _pollStart > timeout) {
+          _pollState = POLL_STATE_IDLE;
+          return POLL_ERROR;
+        }
+        return POLL_BUSY;
+      }
+      _pollState = POLL_STATE_IDLE;
+      _pollTemperatureRequested = false;
+      resetCompleted();
+      return POLL_RESET;
+
+    case POLL_STATE_TEMP_CFG_READ:
+      if(!readByte(_descriptor.tempConfigReg, _pollValue)) {
+        _pollState = POLL_STATE_IDLE;
+        return POLL_ERROR;
+      }
+      _pollState = POLL_STATE_TEMP_CFG_WRITE;
+      return POLL_BUSY;
+
+    case POLL_STATE_TEMP_CFG_WRITE:
+      if(!writeByte(_descriptor.tempConfigReg, _pollValue | (1 << _descriptor.tempConfigBit))) {
+        _pollState = POLL_STATE_IDLE;
+        return POLL_ERROR;
+      }
+      _pollStart = millis();
+      _pollState = POLL_STATE_TEMP_WAIT;
+      return POLL_BUSY;
+
+    case POLL_STATE_TEMP_WAIT: {
+      bool ready;
+      if(!readBit(MAX3010xInterruptDescriptor::stReg(_descriptor.tempReady), MAX3010xInterruptDescriptor::stBit(_descriptor.tempReady), ready)) {
+        _pollState = POLL_STATE_IDLE;
+        return POLL_ERROR;
+      }
+      if(!ready) {
+        if(millis() - _pollStart > timeout) {
+          _pollState = POLL_STATE_IDLE;
+          return POLL_ERROR;
+        }
+        return POLL_BUSY;
+      }
+      _pollState = POLL_STATE_TEMP_READ;
+      return POLL_BUSY;
+    }
+
+    case POLL_STATE_TEMP_READ: {
+      uint8_t temp[2];
+      if(!readBlock(_descriptor.tintReg, sizeof(temp), temp)) {
+        _pollState = POLL_STATE_IDLE;
+        return POLL_ERROR;
+      }
+      _pollTemperature = static_cast<int8_t>(temp[0]) + 0.0625f * temp[1];
+      _pollState = POLL_STATE_IDLE;
+      return POLL_TEMPERATURE;
+    }
+
+    case POLL_STATE_FIFO_READ: {
+      raw.data = buffer;
+      raw.slots = nActiveSlots;
+      raw.sampleSize = _descriptor.sampleSize;
+      raw.resolution = resolutionBits;
+
+      const uint8_t sampleBytes = raw.sampleSize * raw.slots;
+      if(sampleBytes == 0) {
+        _pollState = POLL_STATE_IDLE;
+        return POLL_IDLE;
+      }
+
+      raw.samples = MAX3010x_I2C_BUFFER_SIZE / sampleBytes;
+      if(raw.samples > _pollRemaining) raw.samples = _pollRemaining;
+
+      if(!readFIFOData(_pollReadPointer, raw.samples, sampleBytes, buffer)) {
+        _pollState = POLL_STATE_IDLE;
+        return POLL_ERROR;
+      }
+
+      _pollReadPointer = (_pollReadPointer + raw.samples) % _descriptor.fifoSize;
+      _pollRemaining -= raw.samples;
+      if(_pollRemaining == 0) _pollState = POLL_STATE_IDLE;
+
+      return POLL_SAMPLES;
+    }
+
+    default:
+      if(_pollTemperatureRequested) {
+        _pollTemperatureRequested = false;
+        _pollState = POLL_STATE_TEMP_CFG_READ;
+        return pollStep(raw, buffer, timeout);
+      }
+
+      FIFORegisters fifo;
+      if(!readFIFORegisters(fifo)) return POLL_ERROR;
+
+      _pollRemaining = pendingSamples(fifo);
+      _pollReadPointer = fifo.read;
+      if(_pollRemaining == 0) return POLL_IDLE;
+
+      _pollState = POLL_STATE_FIFO_READ;
+      return POLL_BUSY;
+  }
+}
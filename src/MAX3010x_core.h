@@ -8,384 +8,800 @@
 
 #include "Arduino.h"
 #include "Wire.h"
+#include "MAX3010x_transport.h"
 
-template<class MAX3010xImpl, class MAX3010xSample> class MAX3010x {
-protected:
-  static const uint8_t MAX3010x_ADDR = 0x57;      //!< I2C Device Address
-  static const uint8_t REV_ID_REG = 0xFF;         //!< Revision ID Register
-  static const uint8_t PART_ID_REG = 0xFF;        //!< Part ID Register
-  static const uint8_t MODE_MASK = 0x7;           //!< Mode Mask
-  
-  static const uint8_t FIFO_WR_PTR_REG = MAX3010xImpl::FIFO_BASE;         //!< FIFO Write Pointer Register
-  static const uint8_t FIFO_OVF_CNT_REG = MAX3010xImpl::FIFO_BASE + 1;    //!< FIFO Overflow Counter Register
-  static const uint8_t FIFO_RD_PTR_REG = MAX3010xImpl::FIFO_BASE + 2;     //!< FIFO Read Pointer Register
-  static const uint8_t FIFO_DATA_REG = MAX3010xImpl::FIFO_BASE +3;        //!< FIFO Data Register
+/**
+ * Interrupt Descriptor (see MAX3010xInterruptDescriptor)
+ * 
+ * A distinct type, so plain integers (e.g. enableInterrupt(1)) do not compile.
+ */
+enum class MAX3010xInterrupt : uint16_t {};
+
+/**
+ * Interrupt Descriptor Encoding
+ * 
+ * Each interrupt is described by a single compile-time constant holding the
+ * enable register and bit as well as the status register and bit.
+ * Interrupts without an enable bit use NO_CFG_REG as their enable register.
+ */
+struct MAX3010xInterruptDescriptor {
+  static const uint8_t NO_CFG_REG = 0xF;   //!< Marker for interrupts that can not be enabled or disabled
   
   /**
-   * FIFO Registers
+   * Create Interrupt Descriptor
+   * @remarks Registers must be below 0xF and bits below 8, otherwise the descriptor is not a constant expression and fails to compile
+   * @param cfgReg Enable Register
+   * @param cfgBit Enable Bit
+   * @param stReg Status Register
+   * @param stBit Status Bit
+   * @return Interrupt Descriptor
    */
-  struct FIFORegisters {
-    uint8_t write;    //!< Write Pointer
-    uint8_t overflow; //!< Overflow Counter
-    uint8_t read;     //!< Read Pointer
-  };
-    
-  const uint8_t _addr; //!< I2C Device Address
-  TwoWire& _wire;      //!< I2C Bus Implementation
+  static constexpr MAX3010xInterrupt make(uint8_t cfgReg, uint8_t cfgBit, uint8_t stReg, uint8_t stBit) {
+    return cfgReg <= NO_CFG_REG && cfgBit < 8 && stReg < NO_CFG_REG && stBit < 8
+      ? static_cast<MAX3010xInterrupt>((cfgReg << 12) | (cfgBit << 8) | (stReg << 4) | stBit)
+      : invalid();
+  }
   
   /**
-   * Read Block
-   * @param reg Register
-   * @param count Number of bytes to read
-   * @param buffer Buffer for values
-   * @return true if successful, otherwise false
+   * Create Interrupt Descriptor for an interrupt without enable bit
+   * @param stReg Status Register
+   * @param stBit Status Bit
+   * @return Interrupt Descriptor
    */
-  bool readBlock(uint8_t reg, uint8_t count, uint8_t* buffer) {
-    _wire.beginTransmission(_addr);
-    _wire.write(byte(reg));
-    if(_wire.endTransmission(true)) return false; 
-    
-    if(_wire.requestFrom(_addr, count) != count) return false;
-    if(_wire.available() != count) return false;
-    
-    for(int i = 0; i < count; i++) {
-      buffer[i] = _wire.read();
-    }
-    
-    return true;
+  static constexpr MAX3010xInterrupt make(uint8_t stReg, uint8_t stBit) {
+    return make(NO_CFG_REG, 0, stReg, stBit);
   }
   
   /**
-   * Read Byte
-   * @param reg Register
-   * @param value Reference to uint8_t variable to store the result in
-   * @return true if successful, otherwise false
+   * Check whether an interrupt can be enabled or disabled
+   * @param interrupt Interrupt
+   * @return true if the interrupt has an enable bit
    */
-  bool readByte(uint8_t reg, uint8_t& value) {
-    return readBlock(reg, 1, &value);
-  }
+  static constexpr bool hasCfg(MAX3010xInterrupt interrupt) { return cfgReg(interrupt) != NO_CFG_REG; }
+  static constexpr uint8_t cfgReg(MAX3010xInterrupt interrupt) { return static_cast<uint16_t>(interrupt) >> 12; }          //!< Enable Register
+  static constexpr uint8_t cfgBit(MAX3010xInterrupt interrupt) { return (static_cast<uint16_t>(interrupt) >> 8) & 0x7; }   //!< Enable Bit
+  static constexpr uint8_t stReg(MAX3010xInterrupt interrupt) { return (static_cast<uint16_t>(interrupt) >> 4) & 0xF; }    //!< Status Register
+  static constexpr uint8_t stBit(MAX3010xInterrupt interrupt) { return static_cast<uint16_t>(interrupt) & 0x7; }           //!< Status Bit
+  
+private:
+  static MAX3010xInterrupt invalid();   //!< Not constexpr and not defined: invalid descriptors fail to compile (or to link)
+};
+
+/**
+ * Raw FIFO Data
+ * 
+ * Span over FIFO bytes as they were read from the sensor.
+ * Each sample consists of slots values with sampleSize bytes each (MSB first).
+ */
+struct MAX3010xRawData {
+  const uint8_t* data;    //!< Raw FIFO bytes
+  uint8_t samples;        //!< Number of samples
+  uint8_t slots;          //!< Number of slots per sample
+  uint8_t sampleSize;     //!< Size of a single slot value in bytes
+  uint8_t resolution;     //!< ADC resolution in bits (0 if unknown), values are left-justified
   
   /**
-   * Write Block
-   * @param reg Register
-   * @param count Number of bytes to write
-   * @param buffer Buffer with values
-   * @return true if successful, otherwise false
+   * Decode a single slot value
+   * @param sample Sample index
+   * @param slot Slot index
+   * @return Measurement value
    */
-  bool writeBlock(uint8_t reg, uint8_t count, uint8_t* buffer) {
-    _wire.beginTransmission(_addr);
-    _wire.write(reg);
-    for(int i = 0; i < count; i++) {
-      _wire.write(buffer[i]);
+  uint32_t value(uint8_t sample, uint8_t slot) const {
+    const uint8_t* p = data + (sample * slots + slot) * sampleSize;
+    uint32_t value = 0;
+    for(uint8_t i = 0; i < sampleSize; i++) {
+      value = (value << 8) | p[i];
     }
-    
-    return _wire.endTransmission(true) == 0;
+    // Values are left-justified, bits above bit 17 are undefined
+    return sampleSize == 3 ? value & 0x3FFFF : value;
   }
+};
+
+/**
+ * Asynchronous Drain Callback
+ * @param context User context
+ * @param raw Raw FIFO data (raw.samples is 0 if the transfer failed)
+ */
+typedef void (*MAX3010xDrainCallback)(void* context, const MAX3010xRawData& raw);
+
+/**
+ * Driver Diagnostics
+ * 
+ * Counters are accumulated since the construction of the sensor instance and
+ * can be compared between two snapshots. Histogram bins saturate at 0xFFFF.
+ * 
+ * A drain is a single FIFO data read (readSample(), a burst of readSamples(), drainRaw(),
+ * poll() or startDrain()). Its latency is the time from the FIFO pointer read to the
+ * completion of the data read, i.e. the age of the newest sample when it reaches the application.
+ */
+struct MAX3010xDiagnostics {
+  static const uint8_t LATENCY_BINS = 10;             //!< Number of drain latency bins
+  static const uint8_t LATENCY_BIN_WIDTH_SHIFT = 7;   //!< Upper limit of the first latency bin (2^7 = 128 us)
+  static const uint8_t DRAIN_SIZE_BINS = 6;           //!< Number of samples per drain bins
+  
+  uint32_t addressNacks;          //!< I2C transfers failed with address NACK
+  uint32_t dataNacks;             //!< I2C transfers failed with data NACK
+  uint32_t shortReads;            //!< I2C reads returning fewer bytes than requested
+  uint32_t timeouts;              //!< I2C transfers failed with a bus timeout
+  uint32_t otherErrors;           //!< I2C transfers failed for other or unknown reasons
+  uint32_t readPointerRestores;   //!< FIFO read pointer restores after failed data reads
+  uint32_t samplesLost;           //!< Samples lost due to FIFO overflows
+  uint32_t samplesDiscarded;      //!< Samples discarded by clearFIFO()
+  uint32_t resets;                //!< Completed sensor resets
+  uint32_t partIdMismatches;      //!< Part ID checks with unexpected result
+  uint32_t recoveries;            //!< Successful bus error recoveries
+  uint32_t failedRecoveries;      //!< Failed bus error recoveries
+  uint32_t busClears;             //!< Bus clears during recoveries that released the bus
+  uint32_t reinits;               //!< Sensor re-initializations performed during recoveries
+  unsigned long lastRecoveryMicros; //!< Duration of the last recovery in us
+  unsigned long maxRecoveryMicros;  //!< Duration of the longest recovery in us
+  unsigned long startupMicros;    //!< Duration of the last reset() or begin() including the configuration in us
+  unsigned long firstSampleMicros;  //!< Time from the start of the last reset() or begin() to the first sample read in us (0 until read)
+  unsigned long lastSampleMillis; //!< Time of the last successful FIFO data read in ms
+  uint16_t drainLatency[LATENCY_BINS];      //!< Drain latency histogram, bin i counts latencies below 128 us << i (last bin: all above)
+  uint16_t samplesPerDrain[DRAIN_SIZE_BINS];  //!< Samples per drain histogram, bin i counts 2^i to 2^(i+1)-1 samples (last bin: all above)
   
   /**
-   * Write Byte
-   * @param reg Register
+   * Power of two histogram bin
    * @param value Value
-   * @return true if successful, otherwise false
+   * @param bins Number of bins
+   * @return Bin index (floor(log2(value)), limited to the last bin)
    */
-  bool writeByte(uint8_t reg, uint8_t value) {    
-    return writeBlock(reg, 1, &value);
+  static uint8_t bin(uint32_t value, uint8_t bins) {
+    uint8_t index = 0;
+    while(value > 1 && index < bins - 1) {
+      value >>= 1;
+      index++;
+    }
+    return index;
   }
-  
-  
+
   /**
-   * Read Bit
-   * @param reg Register
-   * @param bit Bit Index
-   * @param value Reference to bool variable to store the result in
-   * @return true if successful, otherwise false
+   * Drain latency histogram bin
+   * @param latency Latency in us
+   * @param bins Number of bins
+   * @return Bin index (0 below 128 us, i from 128 us << (i - 1) to below 128 us << i, limited to the last bin)
    */
-  bool readBit(uint8_t reg, uint8_t bit, bool& value) {
-    uint8_t byte;
-    
-    if(!readByte(reg, byte)) return false;
-    value = (byte >> bit) & 0x1;
-    
-    return true;
+  static uint8_t latencyBin(unsigned long latency, uint8_t bins) {
+    return bin(latency >> (LATENCY_BIN_WIDTH_SHIFT - 1), bins);
   }
   
   /**
-   * Wait for Bit
-   * @param reg Register
-   * @param bit Bit Index
-   * @param expectedState Expected State
-   * @param timeout Timeout in ms
-   * @return true if successful, otherwise false
+   * Count a failed transfer
+   * @param error Error reported by the transport (see MAX3010xTransport::Error)
    */
-  bool waitBit(uint8_t reg, uint8_t bit, bool expectedState = true, int timeout = 100) {
-    bool bitValue = !expectedState;
-    unsigned long startTime = millis();
-    while (bitValue != expectedState) {
-      
-      // Check for bit
-      if(!readBit(reg, bit, bitValue)) {
-        return false;
-      }
-      
-      // Timeout
-      if(millis() - startTime > timeout) {
-        return false;
-      }
-      
-      delay(1);
+  void recordBusError(uint8_t error) {
+    switch(error) {
+      case MAX3010xTransport::ERROR_ADDRESS_NACK: addressNacks++; break;
+      case MAX3010xTransport::ERROR_DATA_NACK: dataNacks++; break;
+      case MAX3010xTransport::ERROR_SHORT_READ: shortReads++; break;
+      case MAX3010xTransport::ERROR_TIMEOUT: timeouts++; break;
+      default: otherErrors++; break;
     }
-    
-    return true;
   }
   
   /**
-   * Set Bit
-   * @param reg Register
-   * @param bit Bit Index
-   * @param value Value
-   * @return true if successful, otherwise false
+   * Count a successful drain
+   * @param latency Drain latency in us
+   * @param samples Number of samples
    */
-  bool setBit(uint8_t reg, uint8_t bit, bool value) {
-    uint8_t byte;
-    
-    if(!readByte(reg, byte)) return false;
-    
-    byte &= ~(1<<bit);
-    
-    if(value) {
-      byte |= 1<<bit;
-    }
-    
-    return writeByte(reg, byte);
+  void recordDrain(unsigned long latency, uint8_t samples) {
+    uint16_t& latencyCount = drainLatency[latencyBin(latency, LATENCY_BINS)];
+    uint16_t& sizeBin = samplesPerDrain[bin(samples, DRAIN_SIZE_BINS)];
+    if(latencyCount != 0xFFFF) latencyCount++;
+    if(sizeBin != 0xFFFF) sizeBin++;
+    lastSampleMillis = millis();
   }
   
   /**
-   * Set Mode (internal)
-   * @param mode Mode
-   * @return true if successful, otherwise false
+   * Count a recovery
+   * @param success true if the recovery was successful, otherwise false
+   * @param duration Duration in us
    */
-  bool setModeInternal(uint8_t mode) {
-    uint8_t value;
-    
-    if(mode & (~ MODE_MASK)) return false;
-    if(!readByte(MAX3010xImpl::MODE_CFG_REG, value)) return false;
-    
-    value &= ~ MODE_MASK;
-    value |= mode;
-    
-    if(!writeByte(MAX3010xImpl::MODE_CFG_REG, value)) return false;
-    return clearFIFO();
+  void recordRecovery(bool success, unsigned long duration) {
+    if(success) recoveries++;
+    else failedRecoveries++;
+    lastRecoveryMicros = duration;
+    if(duration > maxRecoveryMicros) maxRecoveryMicros = duration;
   }
+};
+
+#ifndef MAX3010x_CONFIG_CACHE_SIZE
+#define MAX3010x_CONFIG_CACHE_SIZE 16   //!< Number of configuration registers cached for re-initialization
+#endif
+
+#ifndef MAX3010x_WAIT_BACKOFF_MIN_US
+#define MAX3010x_WAIT_BACKOFF_MIN_US 50     //!< First delay in us between two register polls while waiting for a bit
+#endif
+
+#ifndef MAX3010x_WAIT_BACKOFF_MAX_US
+#define MAX3010x_WAIT_BACKOFF_MAX_US 1000   //!< Maximum delay in us between two register polls while waiting for a bit
+#endif
+
+/**
+ * Back-off of MAX3010xBase::waitBit()
+ *
+ * The delay between two register polls starts at MAX3010x_WAIT_BACKOFF_MIN_US and doubles up to MAX3010x_WAIT_BACKOFF_MAX_US.
+ * The wait ends with the first poll after the timeout, so the delays add up to at most the timeout plus MAX3010x_WAIT_BACKOFF_MAX_US.
+ */
+struct MAX3010xWaitBackoff {
+  /**
+   * Delay following a delay
+   * @param delayUs Delay in us
+   * @return Next delay in us
+   */
+  static constexpr unsigned long next(unsigned long delayUs) {
+    return delayUs < MAX3010x_WAIT_BACKOFF_MAX_US / 2 ? delayUs * 2 : MAX3010x_WAIT_BACKOFF_MAX_US;
+  }
+
+  /**
+   * Maximum number of register polls of a wait that times out
+   * @param timeoutUs Timeout in us
+   * @param delayUs First delay in us
+   * @return Number of polls
+   */
+  static constexpr unsigned long polls(unsigned long timeoutUs, unsigned long delayUs = MAX3010x_WAIT_BACKOFF_MIN_US) {
+    return delayUs > timeoutUs ? 2 : 1 + polls(timeoutUs - delayUs, next(delayUs));
+  }
+};
+
+/**
+ * Bus Error Recovery Policy
+ * 
+ * A failed transfer is recovered in escalating steps until it succeeds:
+ * 1. Retry the transfer up to retries times, waiting retryDelayUs before each retry
+ * 2. Clear the bus (MAX3010xTransport::recoverBus()) and retry if the bus was released
+ * 3. Reset the sensor, restore the cached configuration and retry
+ * 
+ * Bus clears need transport support: MAX3010xWireTransport only clears the bus if it was constructed with
+ * the SDA and SCL pins, sensors constructed with a TwoWire instance skip this step.
+ * 
+ * A step is only started while the elapsed recovery time is below budgetUs.
+ * If the recovery fails, all transfers fail immediately during a back-off period starting with
+ * backoffMs and doubling with every failed recovery up to maxBackoffMs.
+ * 
+ * FIFO data reads are not repeated blindly: The read pointer is restored before each retry.
+ * 
+ * worstCaseMicros() bounds a single recovery. A call of the driver may perform several transfers
+ * that recover one after another: Setters read and write the register (up to 2 recoveries),
+ * a FIFO data read writes the read pointer before each of up to retries repetitions
+ * (up to retries + 1 recoveries plus the repeated data reads). After a failed recovery
+ * the back-off fails the remaining transfers of the call immediately.
+ */
+struct MAX3010xRecoveryPolicy {
+  static const unsigned int BUS_CLEAR_MICROS = 200;   //!< Upper bound of the time needed for a bus clear in us
+  
+  uint8_t retries;              //!< Number of retries
+  unsigned int retryDelayUs;    //!< Delay before each retry in us
+  bool busClear;                //!< Clear the bus if the retries failed
+  bool reinit;                  //!< Reset the sensor and restore the cached configuration if the bus clear failed
+  unsigned int resetTimeoutMs;  //!< Timeout for the sensor reset in ms
+  unsigned long budgetUs;       //!< Time budget for starting recovery steps in us
+  unsigned int backoffMs;       //!< Back-off after the first failed recovery in ms
+  unsigned int maxBackoffMs;    //!< Maximum back-off in ms
   
   /**
    * Constructor
-   * Initializes a new sensor instance
-   * 
-   * @param addr Sensor Address
-   * @param wire TWI bus instance
+   * @param retries Number of retries
+   * @param retryDelayUs Delay before each retry in us
+   * @param busClear Clear the bus if the retries failed (skipped if the transport cannot clear the bus)
+   * @param reinit Reset the sensor and restore the cached configuration if the bus clear failed
+   * @param resetTimeoutMs Timeout for the sensor reset in ms
+   * @param budgetUs Time budget for starting recovery steps in us
+   * @param backoffMs Back-off after the first failed recovery in ms
+   * @param maxBackoffMs Maximum back-off in ms
    */
-  MAX3010x(uint8_t addr, TwoWire& wire) : _addr(addr), _wire(wire) {}
-public:  
+  MAX3010xRecoveryPolicy(uint8_t retries = 2, unsigned int retryDelayUs = 100, bool busClear = true, bool reinit = true, unsigned int resetTimeoutMs = 5, unsigned long budgetUs = 10000, unsigned int backoffMs = 10, unsigned int maxBackoffMs = 1000) :
+    retries(retries),
+    retryDelayUs(retryDelayUs),
+    busClear(busClear),
+    reinit(reinit),
+    resetTimeoutMs(resetTimeoutMs),
+    budgetUs(budgetUs),
+    backoffMs(backoffMs),
+    maxBackoffMs(maxBackoffMs) {}
+  
   /**
-  * Initializes the I2C transport (Wire.begin()) and resets the sensor
-  * @return true if successful, otherwise false
-  */
-  bool begin() {
-    _wire.begin();
-    return reset();
+   * Worst-case duration of a recovery
+   * @remarks The last step may start just before the budget is used up, so the bound is the budget plus the longest step.
+   * @param transferUs Upper bound of the duration of a single transfer in us (e.g. the I2C timeout)
+   * @return Duration in us
+   */
+  unsigned long worstCaseMicros(unsigned long transferUs) const {
+    unsigned long step = retries > 0 ? retryDelayUs + transferUs : 0;
+    if(busClear && BUS_CLEAR_MICROS + transferUs > step) step = BUS_CLEAR_MICROS + transferUs;
+    if(reinit) {
+      // Reset, polling the reset bit with the waitBit() back-off, configuration replay, FIFO clear and the retried transfer
+      const unsigned long timeoutUs = resetTimeoutMs * 1000UL;
+      unsigned long reinitUs = timeoutUs + MAX3010x_WAIT_BACKOFF_MAX_US + (MAX3010xWaitBackoff::polls(timeoutUs) + MAX3010x_CONFIG_CACHE_SIZE + 5) * transferUs;
+      if(reinitUs > step) step = reinitUs;
+    }
+    return budgetUs + step;
   }
-    
+};
+
+/**
+ * Register Bit Field
+ * @tparam REG Register
+ * @tparam BIT Bit Position
+ * @tparam MASK Bit Mask (unshifted)
+ */
+template<uint8_t REG, uint8_t BIT, uint8_t MASK> struct MAX3010xField {
+  static_assert(BIT < 8 && (MASK << BIT) <= 0xFF, "Field exceeds register width");
+  
+  static const uint8_t reg = REG;    //!< Register
+  static const uint8_t bit = BIT;    //!< Bit Position
+  static const uint8_t mask = MASK;  //!< Bit Mask (unshifted)
+};
+
+/**
+ * Chip Descriptor
+ *
+ * Register layout of a sensor type. The chip independent part of the driver (MAX3010xBase)
+ * is parameterised by this descriptor instead of the sensor class, so it is compiled only once
+ * no matter how many sensor types a firmware supports.
+ */
+struct MAX3010xDescriptor {
+  uint8_t partId;               //!< Expected Part ID
+  uint8_t fifoBase;             //!< FIFO Register Base (write pointer, overflow counter, read pointer, data)
+  uint8_t fifoSize;             //!< FIFO Size (Number of samples)
+  uint8_t sampleSize;           //!< Size of a single slot value in bytes
+  uint8_t modeReg;              //!< Mode Configuration Register
+  uint8_t resetBit;             //!< Reset Bit
+  uint8_t shutdownBit;          //!< Shutdown Bit
+  uint8_t tempConfigReg;        //!< Temperature Trigger Register
+  uint8_t tempConfigBit;        //!< Temperature Trigger Bit
+  uint8_t tintReg;              //!< Temperature Register
+  uint8_t tfracReg;             //!< Fractional Temperature Component Register
+  MAX3010xInterrupt tempReady;  //!< Temperature Ready Interrupt
+  MAX3010xInterrupt powerReady; //!< Power Ready Interrupt
+  uint8_t intEnableReg;         //!< First Interrupt Enable Register
+  uint8_t intEnableSize;        //!< Number of Interrupt Enable Registers
+  uint8_t configReg;            //!< First Configuration Register (contiguous range behind the FIFO registers)
+  uint8_t configSize;           //!< Number of Configuration Registers
+  uint8_t proxThresholdReg;     //!< Proximity Interrupt Threshold Register (0 if not available)
+  uint8_t resetActiveSlots;     //!< Number of active slots after a reset
+};
+
+/**
+ * Configuration Snapshot
+ *
+ * Register contents of a sensor taken by saveConfiguration() and written back by restoreConfiguration().
+ * The snapshot is plain data and can be copied or kept in non-volatile memory (e.g. EEPROM.put()).
+ * It only fits sensors with the same part ID.
+ */
+struct MAX3010xConfiguration {
+  static const uint8_t MAX_INT_ENABLE_SIZE = 2;   //!< Maximum number of interrupt enable registers
+  static const uint8_t MAX_CONFIG_SIZE = 11;      //!< Maximum number of configuration registers
+
+  uint8_t partId;                                 //!< Part ID of the sensor (0 if empty)
+  uint8_t interrupts[MAX_INT_ENABLE_SIZE];        //!< Interrupt enable registers
+  uint8_t registers[MAX_CONFIG_SIZE];             //!< Configuration registers (FIFO configuration up to the multi LED configuration)
+  uint8_t proximityThreshold;                     //!< Proximity interrupt threshold (MAX30105 only)
+  uint8_t activeSlots;                            //!< Number of active slots
+  uint8_t configuredSlots;                        //!< Number of configured multi LED slots
+  uint8_t resolutionBits;                         //!< ADC resolution in bits (0 if unknown)
+};
+
+/**
+ * Chip Independent Sensor Driver
+ *
+ * Bus access, error recovery, FIFO handling and the non-blocking state machine shared by all sensors.
+ * Sensor drivers derive from MAX3010x, which supplies the MAX3010xDescriptor of the chip.
+ */
+class MAX3010xBase {
+protected:
+  static const uint8_t MAX3010x_ADDR = 0x57;      //!< I2C Device Address
+  static const uint8_t REV_ID_REG = 0xFF;         //!< Revision ID Register
+  static const uint8_t PART_ID_REG = 0xFF;        //!< Part ID Register
+  static const uint8_t MODE_MASK = 0x7;           //!< Mode Mask
+
+  static const uint8_t FIFO_WR_PTR_OFFSET = 0;    //!< FIFO Write Pointer Register (offset to the FIFO base)
+  static const uint8_t FIFO_OVF_CNT_OFFSET = 1;   //!< FIFO Overflow Counter Register (offset to the FIFO base)
+  static const uint8_t FIFO_RD_PTR_OFFSET = 2;    //!< FIFO Read Pointer Register (offset to the FIFO base)
+  static const uint8_t FIFO_DATA_OFFSET = 3;      //!< FIFO Data Register (offset to the FIFO base)
+
   /**
-  * Resets the sensor to its default settings
-  * @return true if successful, otherwise false
-  */
-  bool reset() {
-    
-    // Reset
-    if(!setBit(MAX3010xImpl::MODE_CFG_REG, MAX3010xImpl::MODE_RST_BIT, true)) return false;
-    if(!waitBit(MAX3010xImpl::MODE_CFG_REG, MAX3010xImpl::MODE_RST_BIT, false)) return false;
-
-    // Identify part
-    if(readPartId() != MAX3010xImpl::MAX3010x_PART_ID) return false;
-    
-    // Enable Temperature Interrupt
-    if(!enableInterrupt(MAX3010xImpl::INT_TEMP_RDY)) return false;
-    
-    // Default Config 
-    if(!static_cast<MAX3010xImpl*>(this)->setDefaultConfiguration()) return false;
-    
-    return true;
+   * FIFO Registers
+   */
+  struct FIFORegisters {
+    uint8_t write;    //!< Write Pointer
+    uint8_t overflow; //!< Overflow Counter
+    uint8_t read;     //!< Read Pointer
+  };
+
+  /**
+   * Internal state of poll()
+   */
+  enum PollState {
+    POLL_STATE_IDLE,              //!< Waiting for samples
+    POLL_STATE_RESET_WRITE,       //!< Trigger Reset
+    POLL_STATE_RESET_WAIT,        //!< Wait for reset to finish
+    POLL_STATE_TEMP_CFG_READ,     //!< Read temperature configuration register
+    POLL_STATE_TEMP_CFG_WRITE,    //!< Trigger temperature conversion
+    POLL_STATE_TEMP_WAIT,         //!< Wait for temperature interrupt
+    POLL_STATE_TEMP_READ,         //!< Read temperature
+    POLL_STATE_FIFO_READ          //!< Read FIFO data
+  };
+
+  const MAX3010xDescriptor& _descriptor;    //!< Chip Descriptor
+  const uint8_t _addr;                      //!< I2C Device Address
+  MAX3010xWireTransport _wireTransport;     //!< Default Transport (Wire)
+  MAX3010xTransport& _transport;            //!< Bus Transport
+  uint8_t resolutionBits;                   //!< Configured ADC resolution in bits (0 if unknown)
+  uint8_t nActiveSlots;                     //!< Number of active LED Slots in FIFO data
+  uint8_t currentMode;                      //!< Configured mode bits (0 after a reset)
+  uint8_t nConfiguredSlots;                 //!< Number of configured multi LED slots (0 without multi LED support)
+
+  MAX3010xRawData _drainData;               //!< Raw data of the pending asynchronous drain
+  MAX3010xDrainCallback _drainCallback;     //!< Callback of the pending asynchronous drain
+  void* _drainContext;                      //!< User context of the pending asynchronous drain
+  uint8_t _drainReadPointer;                //!< FIFO read pointer before the pending asynchronous drain
+  volatile bool _drainBusy;                 //!< Asynchronous drain in progress
+  volatile bool _drainFailed;               //!< Last asynchronous drain failed, read pointer needs to be restored
+
+  uint8_t _pollState;                       //!< Current state of poll()
+  uint8_t _pollValue;                       //!< Register value cached between poll() calls
+  uint8_t _pollRemaining;                   //!< Number of samples left to read from the FIFO
+  uint8_t _pollReadPointer;                 //!< Current FIFO read pointer
+  bool _pollTemperatureRequested;           //!< Temperature measurement requested
+  unsigned long _pollStart;                 //!< Start time of the current wait state in ms
+  float _pollTemperature;                   //!< Last temperature measured by poll()
+
+  uint32_t _samplesRead;                    //!< Number of samples read from the FIFO
+  uint8_t _pendingOverflow;                 //!< Overflow counter at the last FIFO pointer read
+  uint32_t _observedSamples;                //!< Number of samples produced by the sensor at the last FIFO pointer read
+  unsigned long _observedMicros;            //!< Time of the last FIFO pointer read in us
+  MAX3010xDiagnostics _diagnostics;         //!< Driver Diagnostics
+
+  MAX3010xRecoveryPolicy _recoveryPolicy;   //!< Bus Error Recovery Policy
+  bool _recovering;                         //!< Recovery in progress, no nested recovery
+  unsigned int _backoff;                    //!< Current back-off in ms (0 if not backing off)
+  unsigned long _backoffStart;              //!< Start of the current back-off in ms
+  uint8_t _configRegs[MAX3010x_CONFIG_CACHE_SIZE];    //!< Cached configuration registers
+  uint8_t _configValues[MAX3010x_CONFIG_CACHE_SIZE];  //!< Cached configuration values
+  uint8_t _configCount;                     //!< Number of cached configuration registers
+  uint32_t _busClock;                       //!< Configured bus clock in Hz (0 if platform default)
+  unsigned long _startMicros;               //!< Start of the last reset() or begin() in us
+  bool _firstSamplePending;                 //!< No sample read since the last reset() or begin()
+
+  uint8_t pendingSamples(const FIFORegisters& fifo);
+  void cacheRegister(uint8_t reg, uint8_t value);
+  bool reinitialize();
+  bool attemptTransfer(bool write, uint8_t reg, uint8_t count, uint8_t* buffer);
+  bool transfer(bool write, uint8_t reg, uint8_t count, uint8_t* buffer);
+  bool readFIFORegisters(FIFORegisters& fifo);
+  static void drainCompleted(void* context, bool success);
+  bool verifyBus();
+
+  bool readBlock(uint8_t reg, uint8_t count, uint8_t* buffer);
+  bool readByte(uint8_t reg, uint8_t& value);
+  bool writeBlock(uint8_t reg, uint8_t count, uint8_t* buffer);
+  bool writeByte(uint8_t reg, uint8_t value);
+  bool readBit(uint8_t reg, uint8_t bit, bool& value);
+  bool waitBit(uint8_t reg, uint8_t bit, bool expectedState = true, int timeout = 100);
+  bool setBit(uint8_t reg, uint8_t bit, bool value);
+  bool readFIFOData(uint8_t readPointer, uint8_t samples, uint8_t sampleBytes, uint8_t* buffer);
+  bool setField(uint8_t reg, uint8_t bit, uint8_t mask, uint8_t value);
+
+  /**
+   * Set Field
+   * @tparam Field Register field (MAX3010xField)
+   * @param value Unshifted field value
+   * @return true if successful, otherwise false
+   */
+  template<class Field> bool setField(uint8_t value) {
+    return setField(Field::reg, Field::bit, Field::mask, value);
   }
-  
+
+  bool setModeInternal(uint8_t mode);
+  bool beginBus(uint32_t maxClock, uint32_t minClock);
+  bool resetSensor(bool enableTemperatureInterrupt = true);
+  void resetCompleted();
+  bool identifySensor();
+  bool startSensor();
+  void beginStartup();
+  bool endStartup(bool success);
+  bool readSampleData(uint8_t* data, int timeout);
+
+  MAX3010xBase(const MAX3010xDescriptor& descriptor, uint8_t addr, TwoWire& wire);
+  MAX3010xBase(const MAX3010xDescriptor& descriptor, uint8_t addr, MAX3010xTransport& transport);
+public:
+  static const uint32_t BUS_CLOCK_STANDARD = 100000;   //!< Standard mode I2C clock in Hz
+  static const uint32_t BUS_CLOCK_FAST = 400000;       //!< Fast mode I2C clock in Hz, maximum supported by the sensors
+
+  uint32_t busClock();
+
+  bool enableInterrupt(MAX3010xInterrupt interrupt);
+
   /**
   * Enable Interrupt
-  * @param interrupt Interrupt
+  * @tparam interrupt Interrupt (must have an enable bit)
   * @return true if successful, otherwise false
   */
-  bool enableInterrupt(uint8_t interrupt) {
-    if(interrupt >= MAX3010xImpl::INT_CNT) return false;
-    if(MAX3010xImpl::INT_CFG_REG[interrupt] == 0xFF||MAX3010xImpl::INT_CFG_BIT[interrupt] >= 8) return false;
-    return setBit(MAX3010xImpl::INT_CFG_REG[interrupt], MAX3010xImpl::INT_CFG_BIT[interrupt], true);
+  template<MAX3010xInterrupt interrupt> bool enableInterrupt() {
+    static_assert(MAX3010xInterruptDescriptor::hasCfg(interrupt), "Interrupt can not be enabled");
+    return setBit(MAX3010xInterruptDescriptor::cfgReg(interrupt), MAX3010xInterruptDescriptor::cfgBit(interrupt), true);
   }
-  
+
+  bool disableInterrupt(MAX3010xInterrupt interrupt);
+
   /**
   * Disable Interrupt
-  * @param interrupt Interrupt
+  * @tparam interrupt Interrupt (must have an enable bit)
   * @return true if successful, otherwise false
   * @remarks If you disable the temperature interrupt the readTemperature() method will no longer work
   */
-  bool disableInterrupt(uint8_t interrupt) {
-    if(interrupt >= MAX3010xImpl::INT_CNT) return false;
-    if(MAX3010xImpl::INT_CFG_REG[interrupt] == 0xFF||MAX3010xImpl::INT_CFG_BIT[interrupt] >= 8) return false;
-    return setBit(MAX3010xImpl::INT_CFG_REG[interrupt], MAX3010xImpl::INT_CFG_BIT[interrupt], false);
+  template<MAX3010xInterrupt interrupt> bool disableInterrupt() {
+    static_assert(MAX3010xInterruptDescriptor::hasCfg(interrupt), "Interrupt can not be disabled");
+    return setBit(MAX3010xInterruptDescriptor::cfgReg(interrupt), MAX3010xInterruptDescriptor::cfgBit(interrupt), false);
   }
-  
+
+  bool checkInterruptFlag(MAX3010xInterrupt interrupt);
+  bool waitForInterrupt(MAX3010xInterrupt interrupt, int timeout = 100);
+  uint8_t readPartId();
+  uint8_t readRevisionId();
+  bool shutdown();
+  bool wakeUp();
+  float readTemperature();
+  uint8_t available();
+  uint8_t activeSlots();
+  uint8_t readSamples(uint8_t* data, uint8_t maxSamples);
+
   /**
-  * Check for Interrupt Flag
-  * @param interrupt Interrupt
-  * @return true if flag is set, otherwise false
+  * Drains the FIFO and hands the raw data to a callback without decoding
+  * @remarks
+  * The callback is called with a MAX3010xRawData span for every burst read.
+  * The span is only valid during the callback. Use MAX3010xRawData::value() to decode values if needed.
+  * @code
+  * sensor.drainRaw([](const MAX3010xRawData& raw) {
+  *   Serial.write(raw.data, raw.samples * raw.slots * raw.sampleSize);
+  * });
+  * @endcode
+  * @param callback Function or function object accepting a const MAX3010xRawData&
+  * @param maxSamples Maximum number of samples to read (default: all available samples)
+  * @return Number of samples read
   */
-  bool checkInterruptFlag(uint8_t interrupt) {
-    bool value;
-    if(interrupt >= MAX3010xImpl::INT_CNT) return false;
-    if(!readBit(MAX3010xImpl::INT_ST_REG[interrupt], MAX3010xImpl::INT_ST_BIT[interrupt], value)) return false;
-    return value;
+  template<class Callback> uint8_t drainRaw(Callback callback, uint8_t maxSamples = 0xFF) {
+    MAX3010xRawData raw;
+    uint8_t buffer[MAX3010x_I2C_BUFFER_SIZE];
+
+    raw.data = buffer;
+    raw.slots = nActiveSlots;
+    raw.sampleSize = _descriptor.sampleSize;
+    raw.resolution = resolutionBits;
+
+    const uint8_t sampleBytes = raw.sampleSize * raw.slots;
+    if(sampleBytes == 0) return 0;
+
+    FIFORegisters fifo;
+    if(!readFIFORegisters(fifo)) return 0;
+
+    uint8_t count = pendingSamples(fifo);
+    if(count > maxSamples) count = maxSamples;
+
+    const uint8_t chunkSamples = sizeof(buffer) / sampleBytes;
+    uint8_t samplesRead = 0;
+    while(samplesRead < count) {
+      raw.samples = count - samplesRead;
+      if(raw.samples > chunkSamples) raw.samples = chunkSamples;
+
+      if(!readFIFOData((fifo.read + samplesRead) % _descriptor.fifoSize, raw.samples, sampleBytes, buffer)) break;
+      callback(static_cast<const MAX3010xRawData&>(raw));
+      samplesRead += raw.samples;
+    }
+
+    return samplesRead;
   }
-  
+
+  uint8_t readOverflowCounter();
+  uint32_t samplesRead();
+  uint32_t samplesLost();
+  uint32_t samplesDiscarded();
+  uint32_t observedSamples();
+  unsigned long observedMicros();
+  const MAX3010xDiagnostics& diagnostics();
+  void setRecoveryPolicy(const MAX3010xRecoveryPolicy& policy);
+  unsigned long timeSinceLastSample();
+  bool clearFIFO();
+  bool saveConfiguration(MAX3010xConfiguration& configuration);
+  bool restoreConfiguration(const MAX3010xConfiguration& configuration);
+  uint8_t startDrain(uint8_t* buffer, uint8_t size, MAX3010xDrainCallback callback, void* context = nullptr);
+  bool drainPending();
+
   /**
-  * Check for Interrupt Flag
-  * @param interrupt Interrupt
-  * @param timeout Timeout in ms
-  * @return true if flag is set, otherwise false
-  */
-  bool waitForInterrupt(uint8_t interrupt, int timeout = 100) {
-    if(interrupt >= MAX3010xImpl::INT_CNT) return false;
-    return waitBit(MAX3010xImpl::INT_ST_REG[interrupt], MAX3010xImpl::INT_ST_BIT[interrupt], true, 100);
-  }
-  
+   * Result of poll()
+   */
+  enum PollStatus {
+    POLL_IDLE,          //!< Nothing to do, no samples available
+    POLL_BUSY,          //!< Bus operation done, more work pending
+    POLL_SAMPLES,       //!< Samples have been passed to the callback
+    POLL_TEMPERATURE,   //!< Temperature measurement finished, see polledTemperature()
+    POLL_RESET,         //!< Reset finished
+    POLL_ERROR          //!< Bus error or timeout
+  };
+
+  void requestReset();
+  void requestTemperature();
+  float polledTemperature();
+
   /**
-  * Reads the Part Id
-  * @return Part Id or 0xFF on failure
+  * Non-blocking driver step
+  * @remarks
+  * Without errors every call performs at most one bus operation and never waits.
+  * A failed FIFO data read is handled within the same call: the read pointer is restored, the FIFO may be cleared
+  * and retries wait retryDelayUs. With a recovery policy (setRecoveryPolicy()) a call can block for several
+  * recoveries, each bounded by MAX3010xRecoveryPolicy::worstCaseMicros() (see MAX3010xRecoveryPolicy).
+  * Call it from loop() as often as possible. Samples are read in chunks fitting
+  * the I2C buffer and passed to the callback as MAX3010xRawData spans,
+  * which are only valid during the callback.
+  * @param callback Function or function object accepting a const MAX3010xRawData&
+  * @param timeout Timeout in ms for reset and temperature measurements
+  * @return Poll status
   */
-  uint8_t readPartId() {
-    uint8_t partId;
-    if(!readByte(PART_ID_REG, partId)) return 0xFF;
-    return partId;
+  template<class Callback> PollStatus poll(Callback callback, unsigned int timeout = 100) {
+    MAX3010xRawData raw;
+    uint8_t buffer[MAX3010x_I2C_BUFFER_SIZE];
+
+    PollStatus status = pollStep(raw, buffer, timeout);
+    if(status == POLL_SAMPLES) callback(static_cast<const MAX3010xRawData&>(raw));
+    return status;
   }
-  
+protected:
+  PollStatus pollStep(MAX3010xRawData& raw, uint8_t* buffer, unsigned int timeout);
+};
+
+/**
+ * Sensor Driver Core
+ *
+ * Supplies the chip descriptor and the sample decoding of the sensor class MAX3010xImpl.
+ * Everything else is implemented once in MAX3010xBase.
+ */
+template<class MAX3010xImpl, class MAX3010xSample> class MAX3010x : public MAX3010xBase {
+protected:
+  static const MAX3010xDescriptor DESCRIPTOR;   //!< Chip Descriptor
+
   /**
-  * Reads the Revision Id
-  * @return Revision Id or 0xFF on failure
-  */
-  uint8_t readRevisionId() {
-    uint8_t revisionId;
-    if(!readByte(REV_ID_REG, revisionId)) return 0xFF;
-    return revisionId;
+   * Constructor
+   * Initializes a new sensor instance
+   *
+   * @param addr Sensor Address
+   * @param wire TWI bus instance
+   */
+  MAX3010x(uint8_t addr, TwoWire& wire) : MAX3010xBase(DESCRIPTOR, addr, wire) {}
+
+  /**
+   * Constructor
+   * Initializes a new sensor instance using a custom transport
+   *
+   * @param addr Sensor Address
+   * @param transport Bus transport
+   */
+  MAX3010x(uint8_t addr, MAX3010xTransport& transport) : MAX3010xBase(DESCRIPTOR, addr, transport) {}
+
+  /**
+   * Starts the sensor with a saved configuration
+   * @param configuration Configuration saved by saveConfiguration()
+   * @return true if successful, otherwise false
+   */
+  bool start(const MAX3010xConfiguration& configuration) {
+    beginStartup();
+    if(!startSensor()) return false;
+    return endStartup(restoreConfiguration(configuration));
   }
-  
+public:
   /**
-  * Put the sensor in power down mode
+  * Initializes the I2C transport (Wire.begin()) and resets the sensor
+  * @remarks The bus clock is left at the platform default
   * @return true if successful, otherwise false
   */
-  bool shutdown() {
-    return setBit(MAX3010xImpl::MODE_CFG_REG, MAX3010xImpl::MODE_SHDN_BIT, true);
+  bool begin() {
+    _transport.begin();
+    return reset();
   }
-  
+
   /**
-  * Wake up the sensor from power down mode
-  * @return true if successful, otherwise false
+  * Initializes the I2C transport with the fastest working bus clock and resets the sensor
+  * @remarks
+  * The bus clock is set to maxClock (limited to BUS_CLOCK_FAST) and verified by reading the part ID.
+  * If the verification fails (or the transport can't set maxClock), minClock is used instead and verified as well.
+  * Use busClock() to get the chosen clock. Other devices on the same bus need to support the chosen clock.
+  * @param maxClock Maximum I2C clock in Hz
+  * @param minClock Fallback I2C clock in Hz
+  * @return true if successful, false if the verification failed at both clocks or the reset failed
   */
-  bool wakeUp() {
-    return setBit(MAX3010xImpl::MODE_CFG_REG, MAX3010xImpl::MODE_SHDN_BIT, false);
+  bool begin(uint32_t maxClock, uint32_t minClock = BUS_CLOCK_STANDARD) {
+    if(!beginBus(maxClock, minClock)) return false;
+    return reset();
   }
-  
+
   /**
-  * Reads the current sensor temperature
-  * @remarks 
-  * This function will trigger the temperature interrupt once the conversion is finished.
-  * Triggering this interrupt is necessary for this method. If you use the interrupt pin
-  * of the MAX3010x in your application please be aware of this fact.
-  * @return Temperature in °C or NaN
+  * Resets the sensor to its default settings
+  * @return true if successful, otherwise false
   */
-  float readTemperature() {
-    uint8_t tInt;
-    uint8_t tFrac;
-    
-    if(!setBit(MAX3010xImpl::TEMP_CONFIG_REG, MAX3010xImpl::TEMP_CONFIG_BIT, true)) return NAN;
-    if(!waitForInterrupt(MAX3010xImpl::INT_TEMP_RDY)) return NAN;
-    if(!readByte(MAX3010xImpl::TINT_REG, tInt) || !readByte(MAX3010xImpl::TFRAC_REG, tFrac)) return NAN;
-    
-    return tInt + 0.0625f * tFrac;
+  bool reset() {
+    beginStartup();
+    if(!resetSensor()) return false;
+
+    // Default Config
+    return endStartup(static_cast<MAX3010xImpl*>(this)->setDefaultConfiguration());
   }
-  
+
   /**
-  * Reads the number of available samples
-  * @return Number of available samples or 0 on failure
+  * Resets the sensor and restores a saved configuration instead of the default settings
+  * @remarks A few block transfers instead of the register by register default configuration
+  * @param configuration Configuration saved by saveConfiguration()
+  * @return true if successful, otherwise false
   */
-  uint8_t available() {
-    FIFORegisters fifo;
-    if(!readBlock(MAX3010xImpl::FIFO_BASE, sizeof(FIFORegisters), reinterpret_cast<uint8_t*>(&fifo))) return 0;
-    
-    if(fifo.read == fifo.write) {
-      // FIFO is completely full
-      if(fifo.overflow) {
-        return MAX3010xImpl::FIFO_SIZE;
-      }
-    }
-    return (16+fifo.write-fifo.read) % MAX3010xImpl::FIFO_SIZE;
+  bool reset(const MAX3010xConfiguration& configuration) {
+    beginStartup();
+    if(!resetSensor(false)) return false;
+    return endStartup(restoreConfiguration(configuration));
   }
-  
+
   /**
-  * Reads the number lost samples due to FIFO overflow
-  * @return Number of lost samples or 0xFF on failure
+  * Initializes the I2C transport and applies a saved configuration as the first configuration
+  * @remarks
+  * Fast startup for devices that power the sensor for every measurement: The software reset is
+  * skipped if the sensor reports power ready (just powered up), the default configuration is never applied.
+  * See MAX3010xDiagnostics::startupMicros and MAX3010xDiagnostics::firstSampleMicros for the achieved times.
+  * @param configuration Configuration saved by saveConfiguration(), e.g. on the first boot
+  * @return true if successful, otherwise false
   */
-  uint8_t readOverflowCounter() {
-    uint8_t overflowCounter;
-    if(!readByte(FIFO_OVF_CNT_REG, overflowCounter)) return 0xFF;
-    return overflowCounter;
+  bool begin(const MAX3010xConfiguration& configuration) {
+    _transport.begin();
+    return start(configuration);
   }
-  
+
   /**
-  * Clears the FIFO
+  * Initializes the I2C transport with the fastest working bus clock and applies a saved configuration as the first configuration
+  * @remarks See begin(const MAX3010xConfiguration&) and begin(uint32_t, uint32_t)
+  * @param configuration Configuration saved by saveConfiguration()
+  * @param maxClock Maximum I2C clock in Hz
+  * @param minClock Fallback I2C clock in Hz
   * @return true if successful, otherwise false
   */
-  bool clearFIFO() {
-    if(!writeByte(MAX3010xImpl::FIFO_WR_PTR_REG, 0)) return false;
-    if(!writeByte(MAX3010xImpl::FIFO_RD_PTR_REG, 0)) return false;
-    if(!writeByte(MAX3010xImpl::FIFO_OVF_CNT_REG, 0)) return false;
-    return true;
+  bool begin(const MAX3010xConfiguration& configuration, uint32_t maxClock, uint32_t minClock = BUS_CLOCK_STANDARD) {
+    if(!beginBus(maxClock, minClock)) return false;
+    return start(configuration);
   }
-  
+
   /**
   * Read a sample from the FIFO
   * @return Sample or invalid sample in case of an error
   */
   MAX3010xSample readSample(int timeout = 0) {
-    unsigned long startTime = millis();
     MAX3010xSample sample = { 0 };
 
-    FIFORegisters fifo;
-       
-    // Check if there is any data
-    do {
-      if(!readBlock(MAX3010xImpl::FIFO_BASE, sizeof(FIFORegisters), reinterpret_cast<uint8_t*>(&fifo))) return sample;
-      
-      if(fifo.overflow != 0) break;
-      if(timeout > 0 && millis()-startTime >= timeout) return sample;
-    } while(fifo.write == fifo.read);
-    
     uint8_t data[MAX3010xImpl::SAMPLE_SIZE * MAX3010xImpl::MAX_ACTIVE_LEDS] = { 0 };
-    if(!readBlock(MAX3010xImpl::FIFO_DATA_REG, MAX3010xImpl::SAMPLE_SIZE * static_cast<MAX3010xImpl*>(this)->nActiveSlots, data)) {
-      // Restore read pointer in case of an error to allow a retry
-      writeByte(MAX3010xImpl::FIFO_RD_PTR_REG, fifo.read);
-      
-      return sample;
-    }
-    
+    if(!readSampleData(data, timeout)) return sample;
+
     static_cast<MAX3010xImpl*>(this)->fillSampleWithData(data, sample);
-    
+
     return sample;
   }
 };
 
+template<class MAX3010xImpl, class MAX3010xSample> const MAX3010xDescriptor MAX3010x<MAX3010xImpl, MAX3010xSample>::DESCRIPTOR = {
+  MAX3010xImpl::MAX3010x_PART_ID,
+  MAX3010xImpl::FIFO_BASE,
+  MAX3010xImpl::FIFO_SIZE,
+  MAX3010xImpl::SAMPLE_SIZE,
+  MAX3010xImpl::MODE_CFG_REG,
+  MAX3010xImpl::MODE_RST_BIT,
+  MAX3010xImpl::MODE_SHDN_BIT,
+  MAX3010xImpl::TEMP_CONFIG_REG,
+  MAX3010xImpl::TEMP_CONFIG_BIT,
+  MAX3010xImpl::TINT_REG,
+  MAX3010xImpl::TFRAC_REG,
+  MAX3010xImpl::INT_TEMP_RDY,
+  MAX3010xImpl::INT_PWR_RDY,
+  MAX3010xImpl::INT_ENABLE_REG,
+  MAX3010xImpl::INT_ENABLE_SIZE,
+  MAX3010xImpl::CONFIG_REG,
+  MAX3010xImpl::CONFIG_SIZE,
+  MAX3010xImpl::PROX_INT_TRESH_REG,
+  MAX3010xImpl::RESET_ACTIVE_SLOTS
+};
+
 #endif
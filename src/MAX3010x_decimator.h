@@ -0,0 +1,221 @@
+/*!
+ * @file MAX3010x_decimator.h
+ */
+
+
+#ifndef _MAX3010x_DECIMATOR_H
+#define _MAX3010x_DECIMATOR_H
+
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * Arithmetic used by MAX3010xDecimator
+ * @tparam T Sample type
+ */
+template<class T> struct MAX3010xDecimatorTraits;
+
+/**
+ * Floating point arithmetic
+ */
+template<> struct MAX3010xDecimatorTraits<float> {
+  typedef float Coefficient;    //!< Coefficient type
+  typedef float Accumulator;    //!< Accumulator type
+
+  /**
+   * Convert coefficient
+   * @param value Coefficient value
+   * @return Coefficient
+   */
+  static Coefficient coefficient(float value) { return value; }
+
+  /**
+   * Convert accumulator to output sample
+   * @param acc Accumulator
+   * @return Output sample
+   */
+  static float output(Accumulator acc) { return acc; }
+};
+
+/**
+ * Integer arithmetic (Q15 coefficients, 64 bit accumulator)
+ */
+template<> struct MAX3010xDecimatorTraits<int32_t> {
+  typedef int16_t Coefficient;  //!< Coefficient type (Q15)
+  typedef int64_t Accumulator;  //!< Accumulator type
+
+  /**
+   * Convert coefficient
+   * @remarks Saturates to the Q15 range, a single tap of 1.0 becomes 32767 / 32768
+   * @param value Coefficient value
+   * @return Coefficient in Q15 format
+   */
+  static Coefficient coefficient(float value) {
+    const long q = lroundf(value * 32768.0f);
+    return static_cast<Coefficient>(q > 32767 ? 32767 : q < -32768 ? -32768 : q);
+  }
+
+  /**
+   * Convert accumulator to output sample
+   * @param acc Accumulator
+   * @return Output sample
+   */
+  static int32_t output(Accumulator acc) { return static_cast<int32_t>((acc + (1 << 14)) >> 15); }
+};
+
+/**
+ * Decimator
+ *
+ * Decimates high rate acquisitions (e.g. 1600 or 3200 SPS) to a lower output rate using a
+ * windowed-sinc anti-aliasing FIR filter in direct form. The filter is only evaluated on every factor-th input,
+ * so the cost per input sample is kTaps / factor multiply-accumulate operations.
+ *
+ * Typical configurations for an output rate of 100 Hz:
+ * 200 SPS: factor 2, 400 SPS: factor 4, 800 SPS: factor 8, 1000 SPS: factor 10,
+ * 1600 SPS: factor 16, 3200 SPS: factor 32. A filter length of 4 * factor gives good stop band attenuation.
+ *
+ * @tparam kTaps Filter length
+ * @tparam T Sample type (float or int32_t for integer arithmetic)
+ */
+template<uint8_t kTaps, class T = float> class MAX3010xDecimator {
+  static_assert(kTaps > 0, "At least one tap is required");
+
+  typedef MAX3010xDecimatorTraits<T> Traits;
+
+  typename Traits::Coefficient _coefficients[kTaps];  //!< Filter coefficients
+  T _history[kTaps];                                  //!< Input history (ring buffer)
+  uint8_t _factor;                                    //!< Decimation factor
+  uint8_t _index;                                     //!< Write index of the ring buffer
+  uint8_t _phase;                                     //!< Inputs since the last output
+  uint8_t _count;                                     //!< Number of valid inputs in the history
+
+  /**
+   * Compute filter output for the current history
+   * @return Output sample
+   */
+  T compute() const {
+    typename Traits::Accumulator acc = 0;
+    uint8_t j = _index;
+    for(uint8_t i = 0; i < kTaps; i++) {
+      j = j == 0 ? kTaps - 1 : j - 1;
+      acc += static_cast<typename Traits::Accumulator>(_coefficients[i]) * _history[j];
+    }
+    return Traits::output(acc);
+  }
+public:
+  /**
+   * Constructor
+   * @param factor Decimation factor
+   * @param cutoff Cutoff frequency relative to the output Nyquist frequency
+   */
+  MAX3010xDecimator(uint8_t factor, float cutoff = 0.9f) {
+    configure(factor, cutoff);
+  }
+
+  /**
+   * Calculate filter coefficients and reset the filter
+   * @param factor Decimation factor
+   * @param cutoff Cutoff frequency relative to the output Nyquist frequency
+   */
+  void configure(uint8_t factor, float cutoff = 0.9f) {
+    _factor = factor > 0 ? factor : 1;
+
+    // Hamming windowed sinc, normalized to unity gain
+    const float fc = 0.5f * cutoff / _factor;
+    const float center = 0.5f * (kTaps - 1);
+    float h[kTaps];
+    float sum = 0;
+    for(uint8_t i = 0; i < kTaps; i++) {
+      float x = i - center;
+      float sinc = x == 0 ? 2.0f * fc : sinf(2.0f * static_cast<float>(M_PI) * fc * x) / (static_cast<float>(M_PI) * x);
+      float window = kTaps > 1 ? 0.54f - 0.46f * cosf(2.0f * static_cast<float>(M_PI) * i / (kTaps - 1)) : 1.0f;
+      h[i] = sinc * window;
+      sum += h[i];
+    }
+    for(uint8_t i = 0; i < kTaps; i++) {
+      _coefficients[i] = Traits::coefficient(h[i] / sum);
+    }
+
+    reset();
+  }
+
+  /**
+   * Resets the stored values
+   */
+  void reset() {
+    _index = 0;
+    _phase = 0;
+    _count = 0;
+  }
+
+  /**
+   * Decimation factor
+   * @return Decimation factor
+   */
+  uint8_t factor() const {
+    return _factor;
+  }
+
+  /**
+   * Group delay of the filter
+   * @return Delay in input samples
+   */
+  float delay() const {
+    return 0.5f * (kTaps - 1);
+  }
+
+  /**
+   * Process a single input sample
+   * @param value Input sample
+   * @param output Output sample, only written if an output is available
+   * @return true if an output sample is available, otherwise false
+   */
+  bool process(T value, T& output) {
+    _history[_index] = value;
+    _index = _index + 1 == kTaps ? 0 : _index + 1;
+
+    // Fill history with the first value to avoid a start-up transient
+    if(_count == 0) {
+      for(uint8_t i = 0; i < kTaps; i++) _history[i] = value;
+      _count = kTaps;
+    }
+
+    if(++_phase < _factor) return false;
+    _phase = 0;
+
+    output = compute();
+    return true;
+  }
+
+  /**
+   * Process a batch of input samples
+   * @param input Input samples
+   * @param count Number of input samples
+   * @param output Output buffer with space for at least count / factor() + 1 samples
+   * @return Number of output samples
+   */
+  uint8_t process(const T* input, uint8_t count, T* output) {
+    uint8_t n = 0;
+    for(uint8_t i = 0; i < count; i++) {
+      if(process(input[i], output[n])) n++;
+    }
+    return n;
+  }
+
+  /**
+   * Process one slot of a drained FIFO batch (MAX3010xRawData)
+   * @param raw Raw FIFO data
+   * @param slot Slot index
+   * @param output Output buffer with space for at least raw.samples / factor() + 1 samples
+   * @return Number of output samples
+   */
+  template<class Raw> uint8_t process(const Raw& raw, uint8_t slot, T* output) {
+    uint8_t n = 0;
+    for(uint8_t i = 0; i < raw.samples; i++) {
+      if(process(static_cast<T>(raw.value(i, slot)), output[n])) n++;
+    }
+    return n;
+  }
+};
+
+#endif
@@ -52,12 +52,20 @@ protected:
   static const uint8_t SPO2_CFG_ADC_RANGE_BIT = 5;      //!< ADC Range Bit Position
   static const uint8_t SPO2_CFG_ADC_RANGE_MASK = 0x3;   //!< ADC Range Bit Mask
   
+  typedef MAX3010xField<FIFO_CFG_REG, FIFO_SMP_AVE_BIT, FIFO_SMP_AVE_MASK> SampleAveragingField;                 //!< Sample Averaging Field
+  typedef MAX3010xField<SPO2_CFG_REG, SPO2_CFG_RESOLUTION_BIT, SPO2_CFG_RESOLUTION_MASK> ResolutionField;        //!< Resolution Field
+  typedef MAX3010xField<SPO2_CFG_REG, SPO2_CFG_SMP_RATE_BIT, SPO2_CFG_SMP_RATE_MASK> SamplingRateField;          //!< Sampling Rate Field
+  typedef MAX3010xField<SPO2_CFG_REG, SPO2_CFG_ADC_RANGE_BIT, SPO2_CFG_ADC_RANGE_MASK> ADCRangeField;            //!< ADC Range Field
+  
   static const uint8_t LED_CFG_REG_BASE = 0xC;          //!< LED Power Configuration Register Base
   static const uint8_t MULTI_LED_CFG_REG_BASE = 0x11;   //!< LED Power Configuration Register Base
 
-  Mode currentMode;                                     //!< Current Mode
-  uint8_t nActiveSlots;                                 //!< Number of active LED Slots in FIFO data
-  uint8_t nConfiguredSlots;                             //!< Number of configured LED Slots
+  static const uint8_t INT_ENABLE_REG = 0x2;            //!< First Interrupt Enable Register
+  static const uint8_t INT_ENABLE_SIZE = 2;             //!< Number of Interrupt Enable Registers
+  static const uint8_t CONFIG_REG = FIFO_CFG_REG;       //!< First Configuration Register
+  static const uint8_t CONFIG_SIZE = 11;                //!< Number of Configuration Registers (up to the multi LED configuration)
+  static const uint8_t PROX_INT_TRESH_REG = 0;          //!< Proximity Interrupt Threshold Register (not available)
+  static const uint8_t RESET_ACTIVE_SLOTS = 0;          //!< Active slots after a reset (no mode configured)
   
   /**
    * Constructor
@@ -68,6 +76,15 @@ protected:
    */
   MAX3010xMultiLed(uint8_t addr, TwoWire& wire) : MAX3010x<MAX3010xImpl, MAX3010xSample>(addr, wire) {}
   
+  /**
+   * Constructor
+   * Initializes a new sensor instance using a custom transport
+   * 
+   * @param addr Sensor Address
+   * @param transport Bus transport
+   */
+  MAX3010xMultiLed(uint8_t addr, MAX3010xTransport& transport) : MAX3010x<MAX3010xImpl, MAX3010xSample>(addr, transport) {}
+  
   /**
    * Common function for setting the Multi LED Configuration
    * @param activeSlots Number of active slots
@@ -75,12 +92,10 @@ protected:
    * @return true if successful, otherwise false
    */
   bool setMultiLedConfigurationInternal(uint8_t activeSlots, uint8_t cfg[2]) {
-    uint8_t value;
-    
-    if(!MAX3010x<MAX3010xImpl, MAX3010xSample>::writeBlock(MAX3010xImpl::MULTI_LED_CFG_REG_BASE, sizeof(cfg), cfg)) return false;
+    if(!MAX3010x<MAX3010xImpl, MAX3010xSample>::writeBlock(MAX3010xImpl::MULTI_LED_CFG_REG_BASE, 2, cfg)) return false;
     
-    nConfiguredSlots = activeSlots;
-    if(currentMode == MODE_MULTI_LED) nActiveSlots = nConfiguredSlots;
+    this->nConfiguredSlots = activeSlots;
+    if(this->currentMode == MODE_MULTI_LED) this->nActiveSlots = this->nConfiguredSlots;
     
     return MAX3010x<MAX3010xImpl, MAX3010xSample>::clearFIFO();
   }
@@ -93,7 +108,7 @@ protected:
   void fillSampleWithData(uint8_t data[MAX3010xImpl::MAX_ACTIVE_LEDS], MAX3010xSample& sample) {
     sample.valid = true;
     
-    for(int i = 0; i < static_cast<MAX3010xImpl*>(this)->nActiveSlots; i++) {
+    for(int i = 0; i < this->nActiveSlots; i++) {
       sample.slot[i] = (static_cast<uint32_t>(data[0 + SAMPLE_SIZE*i]) << 16) | (static_cast<uint32_t>(data[1 + SAMPLE_SIZE*i]) << 8) | static_cast<uint32_t>(data[2 + SAMPLE_SIZE*i]);
     }
   }
@@ -107,13 +122,12 @@ public:
     uint8_t activeSlots;
     if(mode == MODE_HR_ONLY) activeSlots = 1;
     else if(mode == MODE_SPO2) activeSlots = 2;
-    else if(mode == MODE_MULTI_LED) activeSlots = nConfiguredSlots;
+    else if(mode == MODE_MULTI_LED) activeSlots = this->nConfiguredSlots;
     else return false;
     
     if(!MAX3010x<MAX3010xImpl, MAX3010xSample>::setModeInternal(static_cast<uint8_t>(mode))) return false;
     
-    currentMode = mode;
-    nActiveSlots = activeSlots;
+    this->nActiveSlots = activeSlots;
     
     return true;
   }
@@ -138,15 +152,7 @@ public:
    * @returns true if successful, otherwise false
    */
   bool setSamplingRate(SamplingRate rate) {
-    uint8_t cfg;
-    
-    if(rate & (~ SPO2_CFG_SMP_RATE_MASK)) return false;
-    if(!MAX3010x<MAX3010xImpl, MAX3010xSample>::readByte(SPO2_CFG_REG, cfg)) return false;
-    
-    cfg &= ~(SPO2_CFG_SMP_RATE_MASK << SPO2_CFG_SMP_RATE_BIT);
-    cfg |= (static_cast<uint8_t>(rate) & SPO2_CFG_SMP_RATE_MASK) << SPO2_CFG_SMP_RATE_BIT;
-    
-    return MAX3010x<MAX3010xImpl, MAX3010xSample>::writeByte(SPO2_CFG_REG, cfg);
+    return MAX3010x<MAX3010xImpl, MAX3010xSample>::template setField<SamplingRateField>(static_cast<uint8_t>(rate));
   }
   
   /**
@@ -165,15 +171,7 @@ public:
    * @returns true if successful, otherwise false
    */
   bool setADCRange(ADCRange range) {
-    uint8_t cfg;
-    
-    if(range & (~ SPO2_CFG_ADC_RANGE_MASK)) return false;
-    if(!MAX3010x<MAX3010xImpl, MAX3010xSample>::readByte(SPO2_CFG_REG, cfg)) return false;
-    
-    cfg &= ~(SPO2_CFG_ADC_RANGE_MASK << SPO2_CFG_ADC_RANGE_BIT);
-    cfg |= (static_cast<uint8_t>(range) & SPO2_CFG_ADC_RANGE_MASK) << SPO2_CFG_ADC_RANGE_BIT;
-    
-    return MAX3010x<MAX3010xImpl, MAX3010xSample>::writeByte(SPO2_CFG_REG, cfg);
+    return MAX3010x<MAX3010xImpl, MAX3010xSample>::template setField<ADCRangeField>(static_cast<uint8_t>(range));
   }
   
   /**
@@ -192,15 +190,10 @@ public:
    * @returns true if successful, otherwise false
    */
   bool setResolution(Resolution resolution) {
-    uint8_t cfg;
-    
-    if(resolution & (~ SPO2_CFG_RESOLUTION_MASK)) return false;
-    if(!MAX3010x<MAX3010xImpl, MAX3010xSample>::readByte(SPO2_CFG_REG, cfg)) return false;
+    if(!MAX3010x<MAX3010xImpl, MAX3010xSample>::template setField<ResolutionField>(static_cast<uint8_t>(resolution))) return false;
     
-    cfg &= ~(SPO2_CFG_RESOLUTION_MASK << SPO2_CFG_RESOLUTION_BIT);
-    cfg |= (static_cast<uint8_t>(resolution) & SPO2_CFG_RESOLUTION_MASK) << SPO2_CFG_RESOLUTION_BIT;
-    
-    return MAX3010x<MAX3010xImpl, MAX3010xSample>::writeByte(SPO2_CFG_REG, cfg);
+    MAX3010x<MAX3010xImpl, MAX3010xSample>::resolutionBits = 15 + static_cast<uint8_t>(resolution);
+    return true;
   }
   
   /**
@@ -238,15 +231,61 @@ public:
    * @returns true if successful, otherwise false
    */
   bool setSampleAveraging(SampleAveraging averaging) {
-    uint8_t cfg;
-    
-    if(averaging & (~ FIFO_SMP_AVE_MASK)) return false;
-    if(!MAX3010x<MAX3010xImpl, MAX3010xSample>::readByte(FIFO_CFG_REG, cfg)) return false;
-    
-    cfg &= ~(FIFO_SMP_AVE_MASK << FIFO_SMP_AVE_BIT);
-    cfg |= (static_cast<uint8_t>(averaging) & FIFO_SMP_AVE_MASK) << FIFO_SMP_AVE_BIT;
-    
-    return MAX3010x<MAX3010xImpl, MAX3010xSample>::writeByte(FIFO_CFG_REG, cfg);
+    return MAX3010x<MAX3010xImpl, MAX3010xSample>::template setField<SampleAveragingField>(static_cast<uint8_t>(averaging));
+  }
+  
+  /**
+   * Sampling rate in Hz
+   * @param rate Sampling Rate
+   * @return Samples per second
+   */
+  static constexpr uint16_t samplingRateHz(SamplingRate rate) {
+    return rate == SAMPLING_RATE_50SPS ? 50 : rate == SAMPLING_RATE_100SPS ? 100 : rate == SAMPLING_RATE_200SPS ? 200 :
+           rate == SAMPLING_RATE_400SPS ? 400 : rate == SAMPLING_RATE_800SPS ? 800 : rate == SAMPLING_RATE_1000SPS ? 1000 :
+           rate == SAMPLING_RATE_1600SPS ? 1600 : 3200;
+  }
+  
+  /**
+   * Number of averaged samples
+   * @param averaging Sample averaging
+   * @return Number of samples averaged for each FIFO sample
+   */
+  static constexpr uint8_t averagingFactor(SampleAveraging averaging) {
+    return 1 << static_cast<uint8_t>(averaging);
+  }
+  
+  /**
+   * LED pulse width
+   * @param resolution Resolution and pulse width
+   * @return Pulse width in us
+   */
+  static constexpr uint16_t pulseWidthUs(Resolution resolution) {
+    return resolution == RESOLUTION_15BIT_69US ? 69 : resolution == RESOLUTION_16BIT_118US ? 118 : resolution == RESOLUTION_17BIT_215US ? 215 : 411;
+  }
+  
+  /**
+   * Number of active slots of a mode
+   * @param mode Mode
+   * @return Number of slots (0 for MODE_MULTI_LED, depends on the Multi LED Configuration)
+   */
+  static constexpr uint8_t modeSlots(Mode mode) {
+    return mode == MODE_HR_ONLY ? 1 : mode == MODE_SPO2 ? 2 : 0;
+  }
+  
+  /**
+   * FIFO size
+   * @return Number of samples
+   */
+  static constexpr uint8_t fifoSize() {
+    return MAX3010xImpl::FIFO_SIZE;
+  }
+  
+  /**
+   * Size of a single slot value in the FIFO
+   * @return Size in bytes
+   */
+  static constexpr uint8_t sampleSize() {
+    return SAMPLE_SIZE;
   }
   
 };
@@ -0,0 +1,122 @@
+/*!
+ * @file MAX3010x_pipeline.h
+ */
+
+
+#ifndef _MAX3010x_PIPELINE_H
+#define _MAX3010x_PIPELINE_H
+
+#include <stdint.h>
+
+/**
+ * Signal Processing Pipeline
+ *
+ * Chains filter stages at compile time. A stage is any class with the methods float process(float)
+ * and void reset(), e.g. the filters of the examples. The stages are stored by value and called
+ * directly, so the compiler can inline the whole chain. Batches are processed in a single loop,
+ * every sample passes all stages before the next sample is read, adding a stage does not add a
+ * pass over the batch.
+ *
+ * Usage:
+ * @code
+ * MAX3010xPipeline<LowPassFilter, HighPassFilter, Differentiator> pipeline(
+ *   LowPassFilter(5.0, 400.0), HighPassFilter(0.5, 400.0), Differentiator(400.0));
+ * ...
+ * float diff = pipeline.process(sample.red);
+ * @endcode
+ *
+ * @tparam Stages Stage types in processing order
+ */
+template<class... Stages> class MAX3010xPipeline;
+
+/**
+ * Empty Pipeline (end of the chain)
+ */
+template<> class MAX3010xPipeline<> {
+public:
+  /**
+   * Process a value
+   * @param value Input value
+   * @return Input value
+   */
+  float process(float value) { return value; }
+
+  /**
+   * Resets the stored values
+   */
+  void reset() {}
+};
+
+/**
+ * Signal Processing Pipeline
+ * @tparam Stage First stage
+ * @tparam Stages Remaining stages
+ */
+template<class Stage, class... Stages> class MAX3010xPipeline<Stage, Stages...> {
+  Stage _stage;                     //!< First stage
+  MAX3010xPipeline<Stages...> _next; //!< Remaining stages
+public:
+  /**
+   * Constructor
+   * @param stage First stage
+   * @param stages Remaining stages
+   */
+  MAX3010xPipeline(const Stage& stage, const Stages&... stages) : _stage(stage), _next(stages...) {}
+
+  /**
+   * Process a single value
+   * @param value Input value
+   * @return Output of the last stage
+   */
+  float process(float value) {
+    return _next.process(_stage.process(value));
+  }
+
+  /**
+   * Process a batch of values
+   * @param input Input values
+   * @param output Output values (may be the same buffer as input)
+   * @param count Number of values
+   */
+  void process(const float* input, float* output, uint8_t count) {
+    for(uint8_t i = 0; i < count; i++) {
+      output[i] = process(input[i]);
+    }
+  }
+
+  /**
+   * Process one slot of a drained FIFO batch (MAX3010xRawData)
+   * @param raw Raw FIFO data
+   * @param slot Slot index
+   * @param output Buffer for raw.samples output values
+   * @return Number of output values
+   */
+  template<class Raw> uint8_t process(const Raw& raw, uint8_t slot, float* output) {
+    for(uint8_t i = 0; i < raw.samples; i++) {
+      output[i] = process(static_cast<float>(raw.value(i, slot)));
+    }
+    return raw.samples;
+  }
+
+  /**
+   * Resets the stored values of all stages
+   */
+  void reset() {
+    _stage.reset();
+    _next.reset();
+  }
+
+  /**
+   * First stage
+   * @return Stage
+   */
+  Stage& stage() { return _stage; }
+
+  /**
+   * Remaining stages
+   * @return Pipeline of the remaining stages
+   */
+  MAX3010xPipeline<Stages...>& next() { return _next; }
+};
+
+#endif
@@ -0,0 +1,234 @@
+/*!
+ * @file MAX3010x_profile.h
+ */
+
+
+#ifndef _MAX3010x_PROFILE_H
+#define _MAX3010x_PROFILE_H
+
+#include "MAX3010x_transport.h"
+
+/**
+ * Bus Bandwidth Calculation
+ *
+ * Derived figures of a sensor configuration. All functions are constexpr, so they can be used
+ * in static_assert for fixed configurations (see MAX3010xProfile) as well as at runtime:
+ * @code
+ * float rate = MAX3010xBandwidth::outputRate(MAX30105::samplingRateHz(rate), MAX30105::averagingFactor(averaging));
+ * bool ok = MAX3010xBandwidth::sustainable(rate, slots * MAX30105::sampleSize(), MAX30105::fifoSize(), 400000);
+ * @endcode
+ *
+ * The bus load assumes draining a full FIFO per drain: one pointer read (address, register,
+ * address, 3 bytes) and data reads split into chunks of MAX3010x_I2C_BUFFER_SIZE bytes with
+ * 3 bytes of addressing each. Every byte takes 9 clock cycles.
+ */
+struct MAX3010xBandwidth {
+  static constexpr uint8_t kAddressingBytes = 3;    //!< Addressing bytes of a register read (address, register, address)
+  static constexpr uint8_t kPointerReadBytes = 6;   //!< Bytes of a FIFO pointer read
+  static constexpr uint8_t kBitsPerByte = 9;        //!< Clock cycles per byte (8 data bits and ACK)
+
+  /**
+   * Maximum bus utilization considered sustainable
+   * @return Utilization (0 - 1)
+   */
+  static constexpr float maxUtilization() { return 0.9f; }
+
+  /**
+   * Effective output rate
+   * @param samplingRate Sampling rate in Hz
+   * @param averaging Number of averaged samples
+   * @return FIFO samples per second
+   */
+  static constexpr float outputRate(float samplingRate, uint8_t averaging) {
+    return samplingRate / averaging;
+  }
+
+  /**
+   * Time to fill the FIFO
+   * @param outputRate FIFO samples per second
+   * @param fifoSize FIFO size in samples
+   * @return Time in s
+   */
+  static constexpr float fifoFillTime(float outputRate, uint8_t fifoSize) {
+    return fifoSize / outputRate;
+  }
+
+  /**
+   * Bytes transferred to drain a number of samples
+   * @param samples Number of samples
+   * @param sampleBytes Bytes per sample (slots * sample size)
+   * @return Number of bytes on the bus
+   */
+  static constexpr uint32_t drainBytes(uint8_t samples, uint8_t sampleBytes) {
+    return kPointerReadBytes + static_cast<uint32_t>(samples) * sampleBytes +
+           kAddressingBytes * ((samples + MAX3010x_I2C_BUFFER_SIZE / sampleBytes - 1) / (MAX3010x_I2C_BUFFER_SIZE / sampleBytes));
+  }
+
+  /**
+   * Bus capacity
+   * @param busClock I2C clock in Hz
+   * @return Bytes per second
+   */
+  static constexpr float busCapacity(uint32_t busClock) {
+    return static_cast<float>(busClock) / kBitsPerByte;
+  }
+
+  /**
+   * Required bus bandwidth
+   * @param outputRate FIFO samples per second
+   * @param sampleBytes Bytes per sample (slots * sample size)
+   * @param fifoSize FIFO size in samples
+   * @return Bytes per second
+   */
+  static constexpr float busBytesPerSecond(float outputRate, uint8_t sampleBytes, uint8_t fifoSize) {
+    return drainBytes(fifoSize, sampleBytes) * outputRate / fifoSize;
+  }
+
+  /**
+   * Bus utilization
+   * @param outputRate FIFO samples per second
+   * @param sampleBytes Bytes per sample (slots * sample size)
+   * @param fifoSize FIFO size in samples
+   * @param busClock I2C clock in Hz
+   * @return Utilization (1 = bus fully occupied)
+   */
+  static constexpr float utilization(float outputRate, uint8_t sampleBytes, uint8_t fifoSize, uint32_t busClock) {
+    return busBytesPerSecond(outputRate, sampleBytes, fifoSize) / busCapacity(busClock);
+  }
+
+  /**
+   * Minimum drain period
+   * @remarks Time a drain of the full FIFO occupies the bus
+   * @param sampleBytes Bytes per sample (slots * sample size)
+   * @param fifoSize FIFO size in samples
+   * @param busClock I2C clock in Hz
+   * @return Time in s
+   */
+  static constexpr float minDrainPeriod(uint8_t sampleBytes, uint8_t fifoSize, uint32_t busClock) {
+    return drainBytes(fifoSize, sampleBytes) / busCapacity(busClock);
+  }
+
+  /**
+   * Maximum drain period
+   * @remarks Drains have to be started at least this often to avoid FIFO overflows
+   * @param outputRate FIFO samples per second
+   * @param sampleBytes Bytes per sample (slots * sample size)
+   * @param fifoSize FIFO size in samples
+   * @param busClock I2C clock in Hz
+   * @return Time in s (negative if the FIFO can not be drained in time)
+   */
+  static constexpr float maxDrainPeriod(float outputRate, uint8_t sampleBytes, uint8_t fifoSize, uint32_t busClock) {
+    return fifoFillTime(outputRate, fifoSize) - minDrainPeriod(sampleBytes, fifoSize, busClock);
+  }
+
+  /**
+   * Check whether a configuration can be sustained on the bus
+   * @param outputRate FIFO samples per second
+   * @param sampleBytes Bytes per sample (slots * sample size)
+   * @param fifoSize FIFO size in samples
+   * @param busClock I2C clock in Hz
+   * @return true if the utilization is at most maxUtilization() and the FIFO can be drained in time
+   */
+  static constexpr bool sustainable(float outputRate, uint8_t sampleBytes, uint8_t fifoSize, uint32_t busClock) {
+    return sampleBytes > 0 && sampleBytes <= MAX3010x_I2C_BUFFER_SIZE &&
+           utilization(outputRate, sampleBytes, fifoSize, busClock) <= maxUtilization() &&
+           maxDrainPeriod(outputRate, sampleBytes, fifoSize, busClock) > 0;
+  }
+
+  /**
+   * Time a slot occupies in the sample period (MAX30101, MAX30102, MAX30105)
+   * @remarks
+   * Pulse plus conversion time, chosen so that slots * slotMicros(pulseWidth) <= sample period reproduces the
+   * allowed settings tables of the datasheets. Used for three and four slots, for which no table is given.
+   * @param pulseWidth LED pulse width in us (69, 118, 215 or 411)
+   * @return Time in us (0 for an unknown pulse width)
+   */
+  static constexpr uint16_t slotMicros(uint16_t pulseWidth) {
+    return pulseWidth == 69 ? 312 : pulseWidth == 118 ? 500 : pulseWidth == 215 ? 625 : pulseWidth == 411 ? 1250 : 0;
+  }
+
+  /**
+   * Longest allowed pulse width (MAX30101, MAX30102, MAX30105)
+   * @remarks
+   * One slot: Heart Rate Mode table, two slots: SpO2 Mode table of the datasheet (allowed settings).
+   * Three and four slots (Multi-LED Mode) are derived from slotMicros().
+   * @param samplingRate Sampling rate in Hz
+   * @param slots Number of slots
+   * @return Pulse width in us (0 if no pulse width is allowed)
+   */
+  static constexpr uint16_t maxPulseWidth(float samplingRate, uint8_t slots) {
+    return slots == 1 ? (samplingRate <= 800 ? 411 : samplingRate <= 1600 ? 215 : samplingRate <= 3200 ? 69 : 0) :
+           slots == 2 ? (samplingRate <= 400 ? 411 : samplingRate <= 800 ? 215 : samplingRate <= 1000 ? 118 : samplingRate <= 1600 ? 69 : 0) :
+           slots * slotMicros(411) * samplingRate <= 1e6f ? 411 :
+           slots * slotMicros(215) * samplingRate <= 1e6f ? 215 :
+           slots * slotMicros(118) * samplingRate <= 1e6f ? 118 :
+           slots * slotMicros(69) * samplingRate <= 1e6f ? 69 : 0;
+  }
+
+  /**
+   * Check whether a sampling rate and pulse width are allowed for a number of slots
+   * @param samplingRate Sampling rate in Hz
+   * @param slots Number of slots
+   * @param pulseWidth LED pulse width in us
+   * @return true if the combination is allowed by the datasheet (see maxPulseWidth())
+   */
+  static constexpr bool timingValid(float samplingRate, uint8_t slots, uint16_t pulseWidth) {
+    return slots > 0 && slots <= 4 && slotMicros(pulseWidth) > 0 && pulseWidth <= maxPulseWidth(samplingRate, slots);
+  }
+};
+
+/**
+ * Compile-Time Configuration Profile
+ *
+ * Describes a fixed configuration of a multi LED sensor (MAX30101, MAX30102, MAX30105) and validates it
+ * at compile time. Configurations that can not be sustained on the bus or whose sampling rate and pulse width
+ * are not allowed by the datasheet fail with a static_assert.
+ * @code
+ * typedef MAX3010xProfile<MAX30105, MAX30105::MODE_SPO2, MAX30105::SAMPLING_RATE_400SPS,
+ *                         MAX30105::SMP_AVE_4, MAX30105::RESOLUTION_18BIT_4110US> Profile;
+ * Profile::apply(sensor);
+ * @endcode
+ *
+ * @tparam Sensor Sensor type
+ * @tparam kMode Mode
+ * @tparam kRate Sampling Rate
+ * @tparam kAveraging Sample Averaging
+ * @tparam kResolution Resolution and pulse width
+ * @tparam kSlots Number of slots (0: derived from the mode, required for MODE_MULTI_LED)
+ * @tparam kBusClock I2C clock in Hz
+ */
+template<class Sensor, typename Sensor::Mode kMode, typename Sensor::SamplingRate kRate, typename Sensor::SampleAveraging kAveraging,
+         typename Sensor::Resolution kResolution, uint8_t kSlots = 0, uint32_t kBusClock = 400000> struct MAX3010xProfile {
+  static constexpr uint8_t slots = kSlots > 0 ? kSlots : Sensor::modeSlots(kMode);                 //!< Number of slots
+  static constexpr uint8_t sampleBytes = slots * Sensor::sampleSize();                             //!< Bytes per sample
+  static constexpr uint8_t fifoSize = Sensor::fifoSize();                                         //!< FIFO size in samples
+  static constexpr uint32_t busClock = kBusClock;                                                 //!< I2C clock in Hz
+  static constexpr float samplingRate = Sensor::samplingRateHz(kRate);                            //!< Sampling rate in Hz
+  static constexpr float outputRate = MAX3010xBandwidth::outputRate(samplingRate, Sensor::averagingFactor(kAveraging));     //!< FIFO samples per second
+  static constexpr float fifoFillTime = MAX3010xBandwidth::fifoFillTime(outputRate, fifoSize);                              //!< Time to fill the FIFO in s
+  static constexpr float busBytesPerSecond = MAX3010xBandwidth::busBytesPerSecond(outputRate, sampleBytes, fifoSize);       //!< Required bus bandwidth in bytes per second
+  static constexpr float utilization = MAX3010xBandwidth::utilization(outputRate, sampleBytes, fifoSize, kBusClock);        //!< Bus utilization
+  static constexpr float minDrainPeriod = MAX3010xBandwidth::minDrainPeriod(sampleBytes, fifoSize, kBusClock);              //!< Minimum drain period in s
+  static constexpr float maxDrainPeriod = MAX3010xBandwidth::maxDrainPeriod(outputRate, sampleBytes, fifoSize, kBusClock);  //!< Maximum drain period in s
+
+  static_assert(slots > 0 && slots <= 4, "Number of slots is required for MODE_MULTI_LED");
+  static_assert(MAX3010xBandwidth::timingValid(samplingRate, slots, Sensor::pulseWidthUs(kResolution)), "Sampling rate and pulse width are not allowed for the number of slots (datasheet allowed settings), reduce resolution or sampling rate");
+  static_assert(MAX3010xBandwidth::sustainable(outputRate, sampleBytes, fifoSize, kBusClock), "Configuration can not be sustained on the bus, increase averaging or bus clock or reduce sampling rate or slots");
+
+  /**
+   * Apply the profile
+   * @remarks For MODE_MULTI_LED the Multi LED Configuration needs to be set before.
+   * The sensor has to be started with begin(maxClock, minClock), so that busClock() reports the chosen clock.
+   * @param sensor Sensor
+   * @return true if successful, false if the bus clock is below kBusClock (or unknown) or a setting failed
+   */
+  static bool apply(Sensor& sensor) {
+    if(sensor.busClock() < kBusClock) return false;
+    if(!sensor.setSamplingRate(kRate)) return false;
+    if(!sensor.setSampleAveraging(kAveraging)) return false;
+    if(!sensor.setResolution(kResolution)) return false;
+    return sensor.setMode(kMode);
+  }
+};
+
+#endif
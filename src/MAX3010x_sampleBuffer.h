@@ -0,0 +1,280 @@
+/*!
+ * @file MAX3010x_sampleBuffer.h
+ */
+
+
+#ifndef _MAX3010x_SAMPLE_BUFFER_H
+#define _MAX3010x_SAMPLE_BUFFER_H
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Packed Sample Buffer
+ *
+ * Ring buffer that stores samples in the raw FIFO format (3 bytes per slot, 2 bytes for the MAX30100)
+ * instead of decoded sample structs. A MAX30105Sample occupies 20 bytes, a packed SpO2 sample 6 bytes
+ * and a packed single LED sample 3 bytes. 10 seconds of SpO2 data at 100 SPS therefore need 6000 bytes
+ * instead of 20000 bytes.
+ *
+ * Sequence numbers are not stored per sample. Instead a header is stored for each run of consecutive
+ * samples, a new run is only started if samples were lost (e.g. due to a FIFO overflow).
+ *
+ * The buffer can be filled directly by the sensor's burst read:
+ * @code
+ * uint16_t count = 32;
+ * uint8_t* data = buffer.reserve(count);
+ * buffer.commit(sensor.readSamples(data, count));
+ * @endcode
+ *
+ * @tparam kBytes Size of the sample storage in bytes
+ * @tparam kMaxRuns Maximum number of runs (sequence headers)
+ * @tparam kSampleSize Size of a single slot value in bytes (3, 2 for the MAX30100)
+ */
+template<uint16_t kBytes, uint8_t kMaxRuns = 8, uint8_t kSampleSize = 3> class MAX3010xSampleBuffer {
+  static_assert(kSampleSize == 2 || kSampleSize == 3, "Unsupported sample size");
+  static_assert(kMaxRuns > 0, "At least one run is required");
+  static_assert(kBytes >= 4 * kSampleSize, "Buffer requires space for at least one sample with four slots");
+
+  static const uint16_t kMaxReserve = 0xFF;   //!< Maximum reservation in samples (readSamples() reads up to 255 samples)
+
+  /**
+   * Run of consecutive samples
+   */
+  struct Run {
+    uint32_t sequence;  //!< Sequence number of the first sample
+    uint16_t count;     //!< Number of samples
+  };
+
+  uint8_t _data[kBytes];    //!< Sample Storage
+  Run _runs[kMaxRuns];      //!< Run Headers
+  uint8_t _slots;           //!< Number of slots per sample
+  uint8_t _sampleBytes;     //!< Number of bytes per sample
+  uint16_t _capacity;       //!< Capacity in samples
+  uint16_t _head;           //!< Index of the oldest sample
+  uint16_t _size;           //!< Number of stored samples
+  uint8_t _firstRun;        //!< Index of the oldest run
+  uint8_t _nRuns;           //!< Number of runs
+  uint32_t _nextSequence;   //!< Sequence number of the next sample
+
+  /**
+   * Drop the oldest samples
+   * @param count Number of samples
+   */
+  void drop(uint16_t count) {
+    if(count > _size) count = _size;
+
+    _head = (_head + count) % _capacity;
+    _size -= count;
+
+    while(count > 0) {
+      Run& run = _runs[_firstRun];
+      uint16_t n = count < run.count ? count : run.count;
+      run.sequence += n;
+      run.count -= n;
+      count -= n;
+
+      if(run.count == 0) {
+        _firstRun = (_firstRun + 1) % kMaxRuns;
+        _nRuns--;
+      }
+    }
+  }
+
+  /**
+   * Get pointer to a stored sample
+   * @param index Sample index (0 is the oldest sample)
+   * @return Pointer to the raw sample data
+   */
+  const uint8_t* raw(uint16_t index) const {
+    return _data + static_cast<uint16_t>((_head + index) % _capacity) * _sampleBytes;
+  }
+public:
+  /**
+   * Constructor
+   * @param slots Number of active slots per sample
+   */
+  MAX3010xSampleBuffer(uint8_t slots = 2) {
+    configure(slots);
+  }
+
+  /**
+   * Set the number of active slots per sample and clear the buffer
+   * @param slots Number of active slots per sample (1 - 4)
+   */
+  void configure(uint8_t slots) {
+    _slots = slots < 1 ? 1 : slots > 4 ? 4 : slots;
+    _sampleBytes = _slots * kSampleSize;
+    _capacity = kBytes / _sampleBytes;
+    _nextSequence = 0;
+    clear();
+  }
+
+  /**
+   * Remove all samples
+   * @remarks Sequence numbers continue after clear()
+   */
+  void clear() {
+    _head = 0;
+    _size = 0;
+    _firstRun = 0;
+    _nRuns = 0;
+  }
+
+  /**
+   * Reserve contiguous space for new samples
+   * @remarks
+   * If the buffer is full, the reserved space still holds the oldest samples. They are only dropped by commit()
+   * for the samples actually written, a failed read may corrupt them though.
+   * Call commit() with the number of samples that were actually written.
+   * @param count Number of samples requested, is reduced to the contiguous space available
+   * and to 255 samples, the maximum of a single readSamples() call
+   * @return Pointer to write the raw sample data to
+   */
+  uint8_t* reserve(uint16_t& count) {
+    uint16_t tail = (_head + _size) % _capacity;
+    if(count > _capacity - tail) count = _capacity - tail;
+    if(count > kMaxReserve) count = kMaxReserve;
+
+    return _data + tail * _sampleBytes;
+  }
+
+  /**
+   * Commit samples written to reserved space
+   * @remarks The oldest samples are dropped if the buffer is full
+   * @param count Number of samples (at most the reserved count)
+   * @param lost Number of samples lost before these samples (e.g. FIFO overflow counter)
+   */
+  void commit(uint16_t count, uint8_t lost = 0) {
+    _nextSequence += lost;
+    if(count == 0) return;
+
+    // The new samples overwrote the oldest ones
+    if(_size + count > _capacity) drop(_size + count - _capacity);
+
+    if(_nRuns > 0 && lost == 0) {
+      // Extend current run
+      _runs[(_firstRun + _nRuns - 1) % kMaxRuns].count += count;
+    }
+    else {
+      // Start new run, drop the oldest run if there is no space left
+      if(_nRuns == kMaxRuns) drop(_runs[_firstRun].count);
+
+      Run& run = _runs[(_firstRun + _nRuns) % kMaxRuns];
+      run.sequence = _nextSequence;
+      run.count = count;
+      _nRuns++;
+    }
+
+    _size += count;
+    _nextSequence += count;
+  }
+
+  /**
+   * Append raw samples
+   * @param data Raw sample data as read from the FIFO
+   * @param count Number of samples
+   * @param lost Number of samples lost before these samples
+   */
+  void append(const uint8_t* data, uint16_t count, uint8_t lost = 0) {
+    while(count > 0) {
+      uint16_t n = count;
+      uint8_t* dst = reserve(n);
+      memcpy(dst, data, n * _sampleBytes);
+      commit(n, lost);
+
+      data += n * _sampleBytes;
+      count -= n;
+      lost = 0;
+    }
+  }
+
+  /**
+   * Number of stored samples
+   * @return Number of samples
+   */
+  uint16_t size() const {
+    return _size;
+  }
+
+  /**
+   * Capacity
+   * @return Maximum number of samples with the current slot configuration
+   */
+  uint16_t capacity() const {
+    return _capacity;
+  }
+
+  /**
+   * Number of slots per sample
+   * @return Number of slots
+   */
+  uint8_t slots() const {
+    return _slots;
+  }
+
+  /**
+   * Random access to a slot value
+   * @param index Sample index (0 is the oldest sample)
+   * @param slot Slot index
+   * @return Measurement value
+   */
+  uint32_t value(uint16_t index, uint8_t slot) const {
+    const uint8_t* p = raw(index) + slot * kSampleSize;
+    if(kSampleSize == 3) {
+      return ((static_cast<uint32_t>(p[0]) << 16) | (static_cast<uint32_t>(p[1]) << 8) | p[2]) & 0x3FFFF;
+    }
+    return (static_cast<uint32_t>(p[0]) << 8) | p[1];
+  }
+
+  /**
+   * Sequence number of a sample
+   * @remarks Gaps in the sequence numbers indicate lost samples
+   * @param index Sample index (0 is the oldest sample)
+   * @return Sequence number
+   */
+  uint32_t sequence(uint16_t index) const {
+    for(uint8_t i = 0; i < _nRuns; i++) {
+      const Run& run = _runs[(_firstRun + i) % kMaxRuns];
+      if(index < run.count) return run.sequence + index;
+      index -= run.count;
+    }
+    return _nextSequence;
+  }
+
+  /**
+   * Random access to a sample
+   * @tparam Sample Sample type of the sensor (e.g. MAX30105Sample)
+   * @param index Sample index (0 is the oldest sample)
+   * @return Sample or invalid sample if index is out of range
+   */
+  template<class Sample> Sample sample(uint16_t index) const {
+    Sample sample = { 0 };
+    if(index >= _size) return sample;
+
+    const uint8_t n = _slots < sizeof(sample.slot) / sizeof(sample.slot[0]) ? _slots : sizeof(sample.slot) / sizeof(sample.slot[0]);
+    for(uint8_t i = 0; i < n; i++) {
+      sample.slot[i] = value(index, i);
+    }
+    sample.valid = true;
+    return sample;
+  }
+
+  /**
+   * Sequential access, removes the oldest sample
+   * @tparam Sample Sample type of the sensor (e.g. MAX30105Sample)
+   * @param sample Sample to fill
+   * @param sequence Optional pointer to store the sequence number
+   * @return true if a sample was available, otherwise false
+   */
+  template<class Sample> bool pop(Sample& sample, uint32_t* sequence = nullptr) {
+    if(_size == 0) return false;
+
+    sample = this->template sample<Sample>(0);
+    if(sequence) *sequence = _runs[_firstRun].sequence;
+    drop(1);
+    return true;
+  }
+};
+
+#endif
@@ -0,0 +1,161 @@
+/*!
+ * @file MAX3010x_signalQuality.h
+ */
+
+
+#ifndef _MAX3010x_SIGNAL_QUALITY_H
+#define _MAX3010x_SIGNAL_QUALITY_H
+
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * Streaming Signal Quality Index
+ *
+ * Tracks the quality of a PPG channel with a constant amount of work per sample:
+ * - Perfusion index: pulsatile (AC) amplitude relative to the DC level
+ * - Clipping ratio: fraction of samples at the end of the ADC range
+ * - Skewness and kurtosis of the pulsatile component (beat shape SQIs)
+ *
+ * All statistics are exponentially weighted with the configured time constant.
+ * Downstream heart rate or SpO2 calculations can be skipped while usable() is false.
+ */
+class MAX3010xSignalQuality {
+  float _dcAlpha;       //!< Smoothing factor for the DC level
+  float _acAlpha;       //!< Smoothing factor for the AC statistics
+  uint32_t _fullScale;  //!< Full scale value of the ADC
+  float _dc;            //!< DC level
+  float _m2;            //!< Second central moment
+  float _m3;            //!< Third central moment
+  float _m4;            //!< Fourth central moment
+  float _clipping;      //!< Clipping ratio
+  uint16_t _count;      //!< Number of samples since reset (saturating)
+public:
+  /**
+   * Constructor
+   * @param samplingRate Sampling rate in Hz
+   * @param timeConstant Time constant of the statistics in seconds
+   * @param sampleSize Size of a FIFO value in bytes (3, 2 for the MAX30100), determines the full scale value
+   */
+  MAX3010xSignalQuality(float samplingRate, float timeConstant = 3.0f, uint8_t sampleSize = 3) {
+    configure(samplingRate, timeConstant, sampleSize);
+  }
+
+  /**
+   * Configure the estimator and reset the stored values
+   * @param samplingRate Sampling rate in Hz
+   * @param timeConstant Time constant of the statistics in seconds
+   * @param sampleSize Size of a FIFO value in bytes (3, 2 for the MAX30100)
+   */
+  void configure(float samplingRate, float timeConstant = 3.0f, uint8_t sampleSize = 3) {
+    _acAlpha = 1.0f / (samplingRate * timeConstant);
+    _dcAlpha = 1.0f / (samplingRate * 1.5f);
+    if(_acAlpha > 1.0f) _acAlpha = 1.0f;
+    if(_dcAlpha > 1.0f) _dcAlpha = 1.0f;
+
+    // FIFO values are left-justified, so the full scale value does not depend on the resolution
+    _fullScale = sampleSize == 3 ? 0x3FFFF : 0xFFFF;
+    reset();
+  }
+
+  /**
+   * Resets the stored values
+   */
+  void reset() {
+    _dc = 0;
+    _m2 = 0;
+    _m3 = 0;
+    _m4 = 0;
+    _clipping = 0;
+    _count = 0;
+  }
+
+  /**
+   * Add a sample
+   * @param value Raw measurement value
+   */
+  void process(uint32_t value) {
+    const bool clipped = value >= _fullScale - (_fullScale >> 7);
+    const float x = value;
+
+    if(_count == 0) _dc = x;
+    else _dc += _dcAlpha * (x - _dc);
+    if(_count < 0xFFFF) _count++;
+
+    const float d = x - _dc;
+    const float d2 = d * d;
+    _m2 += _acAlpha * (d2 - _m2);
+    _m3 += _acAlpha * (d2 * d - _m3);
+    _m4 += _acAlpha * (d2 * d2 - _m4);
+    _clipping += _acAlpha * ((clipped ? 1.0f : 0.0f) - _clipping);
+  }
+
+  /**
+   * Add one slot of a drained FIFO batch (MAX3010xRawData)
+   * @param raw Raw FIFO data
+   * @param slot Slot index
+   */
+  template<class Raw> void process(const Raw& raw, uint8_t slot) {
+    for(uint8_t i = 0; i < raw.samples; i++) process(raw.value(i, slot));
+  }
+
+  /**
+   * DC level
+   * @return DC level in ADC counts
+   */
+  float dc() const {
+    return _dc;
+  }
+
+  /**
+   * Perfusion Index
+   * @remarks Peak-to-peak amplitude estimated from the RMS value of the AC component (2 * sqrt(2) * RMS)
+   * @return Perfusion index in percent
+   */
+  float perfusionIndex() const {
+    return _dc > 0 ? 2.828427f * sqrtf(_m2) / _dc * 100.0f : 0;
+  }
+
+  /**
+   * Clipping Ratio
+   * @return Fraction of samples at the end of the ADC range (0 - 1)
+   */
+  float clipping() const {
+    return _clipping;
+  }
+
+  /**
+   * Skewness of the pulsatile component
+   * @remarks Clean PPG signals have a clearly non-zero skewness, noise and motion artefacts push it towards zero
+   * @return Skewness
+   */
+  float skewness() const {
+    return _m2 > 0 ? _m3 / (_m2 * sqrtf(_m2)) : 0;
+  }
+
+  /**
+   * Kurtosis of the pulsatile component
+   * @remarks Spikes and motion artefacts cause a high kurtosis, a sine wave has a kurtosis of 1.5
+   * @return Kurtosis (not excess kurtosis)
+   */
+  float kurtosis() const {
+    return _m2 > 0 ? _m4 / (_m2 * _m2) : 0;
+  }
+
+  /**
+   * Check whether the signal is usable for further processing
+   * @param minPerfusionIndex Minimum perfusion index in percent
+   * @param maxPerfusionIndex Maximum perfusion index in percent (higher values indicate motion)
+   * @param maxClipping Maximum clipping ratio
+   * @param maxKurtosis Maximum kurtosis
+   * @return true if the signal quality is sufficient, otherwise false
+   */
+  bool usable(float minPerfusionIndex = 0.05f, float maxPerfusionIndex = 20.0f, float maxClipping = 0.01f, float maxKurtosis = 5.0f) const {
+    if(_count < 1.0f / _acAlpha) return false;
+
+    const float pi = perfusionIndex();
+    return pi >= minPerfusionIndex && pi <= maxPerfusionIndex && _clipping <= maxClipping && kurtosis() <= maxKurtosis;
+  }
+};
+
+#endif
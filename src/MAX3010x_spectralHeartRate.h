@@ -0,0 +1,203 @@
+/*!
+ * @file MAX3010x_spectralHeartRate.h
+ */
+
+
+#ifndef _MAX3010x_SPECTRAL_HEART_RATE_H
+#define _MAX3010x_SPECTRAL_HEART_RATE_H
+
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * Spectral Heart Rate Estimator
+ *
+ * Estimates the heart rate from the dominant frequency of the PPG signal within 40 - 240 BPM.
+ * A sliding DFT is evaluated for the DFT bins within this range only. Each input sample updates
+ * all bins in O(bins), so no window needs to be recomputed and estimate() only searches the bins.
+ *
+ * The frequency resolution is samplingRate / kWindow, the peak is refined by parabolic interpolation.
+ * Example: 25 Hz input (e.g. decimated), kWindow = 256 (10.2 s): 5.9 BPM bin spacing, 35 bins,
+ * i.e. 35 complex multiply-accumulates per sample (875 per second).
+ *
+ * The search range needs about 3.33 * kWindow / samplingRate + 1 bins (at most kWindow / 2),
+ * e.g. 68 bins for kWindow = 512 at 25 Hz. configure() fails if kMaxBins is too small.
+ *
+ * @tparam kWindow Window length in samples
+ * @tparam kMaxBins Maximum number of DFT bins
+ */
+template<uint16_t kWindow, uint8_t kMaxBins = 48> class MAX3010xSpectralHeartRate {
+  static_assert(kWindow > 1, "Window is too short");
+  static_assert(kMaxBins >= 3, "At least 3 bins are required");
+
+  static constexpr float kMinBpm = 40.0f;     //!< Lower limit of the search range
+  static constexpr float kMaxBpm = 240.0f;    //!< Upper limit of the search range
+  static constexpr float kDamping = 0.9999f;  //!< Damping factor for numerical stability
+
+  float _samplingRate;          //!< Sampling rate in Hz
+  uint16_t _firstBin;           //!< Index of the first DFT bin
+  uint8_t _nBins;               //!< Number of DFT bins
+  float _twiddleRe[kMaxBins];   //!< Twiddle factors (real part)
+  float _twiddleIm[kMaxBins];   //!< Twiddle factors (imaginary part)
+  float _binRe[kMaxBins];       //!< DFT bins (real part)
+  float _binIm[kMaxBins];       //!< DFT bins (imaginary part)
+  float _window[kWindow];       //!< Input history (ring buffer)
+  float _dampingN;              //!< Damping factor to the power of kWindow
+  float _offset;                //!< Offset subtracted from the input
+  uint16_t _index;              //!< Write index of the ring buffer
+  uint16_t _count;              //!< Number of samples in the window
+  float _bpm;                   //!< Last heart rate estimate
+  float _confidence;            //!< Confidence of the last estimate
+public:
+  /**
+   * Constructor
+   * @remarks If the search range does not fit kMaxBins no estimate is made, see configure()
+   * @param samplingRate Sampling rate in Hz
+   */
+  MAX3010xSpectralHeartRate(float samplingRate) {
+    configure(samplingRate);
+  }
+
+  /**
+   * Set sampling rate and reset the estimator
+   * @param samplingRate Sampling rate in Hz
+   * @return true if successful, false if the search range needs more than kMaxBins or less than 3 bins
+   */
+  bool configure(float samplingRate) {
+    _samplingRate = samplingRate;
+
+    float resolution = samplingRate / kWindow;
+    _firstBin = static_cast<uint16_t>(ceilf(kMinBpm / 60.0f / resolution));
+    if(_firstBin < 1) _firstBin = 1;
+    uint16_t lastBin = static_cast<uint16_t>(floorf(kMaxBpm / 60.0f / resolution));
+    if(lastBin > kWindow / 2) lastBin = kWindow / 2;
+    const uint16_t nBins = lastBin >= _firstBin ? lastBin - _firstBin + 1 : 0;
+
+    // Truncating the bins would silently limit the heart rate range, no estimates are made instead
+    _nBins = nBins <= kMaxBins ? nBins : 0;
+
+    for(uint8_t i = 0; i < _nBins; i++) {
+      float phi = 2.0f * static_cast<float>(M_PI) * (_firstBin + i) / kWindow;
+      _twiddleRe[i] = kDamping * cosf(phi);
+      _twiddleIm[i] = kDamping * sinf(phi);
+    }
+    _dampingN = powf(kDamping, kWindow);
+
+    reset();
+    return _nBins >= 3;
+  }
+
+  /**
+   * Resets the stored values
+   */
+  void reset() {
+    for(uint8_t i = 0; i < _nBins; i++) {
+      _binRe[i] = 0;
+      _binIm[i] = 0;
+    }
+    _index = 0;
+    _count = 0;
+    _offset = 0;
+    _bpm = NAN;
+    _confidence = 0;
+  }
+
+  /**
+   * Add a sample
+   * @param value Sample value
+   */
+  void process(float value) {
+    if(_count == 0) _offset = value;
+    value -= _offset;
+
+    float old = 0;
+    if(_count == kWindow) old = _window[_index];
+    else _count++;
+    _window[_index] = value;
+    _index = _index + 1 == kWindow ? 0 : _index + 1;
+
+    const float delta = value - _dampingN * old;
+    for(uint8_t i = 0; i < _nBins; i++) {
+      float re = _binRe[i] + delta;
+      float im = _binIm[i];
+      _binRe[i] = re * _twiddleRe[i] - im * _twiddleIm[i];
+      _binIm[i] = re * _twiddleIm[i] + im * _twiddleRe[i];
+    }
+  }
+
+  /**
+   * Add a batch of samples
+   * @param values Sample values
+   * @param count Number of samples
+   */
+  void process(const float* values, uint8_t count) {
+    for(uint8_t i = 0; i < count; i++) process(values[i]);
+  }
+
+  /**
+   * Check whether the window is filled
+   * @return true if enough samples were processed for an estimate (never if configure() failed)
+   */
+  bool ready() const {
+    return _count == kWindow && _nBins >= 3;
+  }
+
+  /**
+   * Search the spectral peak
+   * @return true if an estimate is available (see bpm() and confidence()), otherwise false
+   */
+  bool estimate() {
+    if(!ready()) return false;
+
+    // Find peak
+    uint8_t peak = 0;
+    float peakPower = -1;
+    for(uint8_t i = 0; i < _nBins; i++) {
+      float power = _binRe[i] * _binRe[i] + _binIm[i] * _binIm[i];
+      if(power > peakPower) {
+        peakPower = power;
+        peak = i;
+      }
+    }
+
+    // Strongest competitor outside the main lobe
+    float secondPower = 0;
+    for(uint8_t i = 0; i < _nBins; i++) {
+      if(i + 1 >= peak && i <= peak + 1) continue;
+      float power = _binRe[i] * _binRe[i] + _binIm[i] * _binIm[i];
+      if(power > secondPower) secondPower = power;
+    }
+
+    // Parabolic interpolation on magnitudes
+    float shift = 0;
+    if(peak > 0 && peak + 1 < _nBins) {
+      float a = sqrtf(_binRe[peak - 1] * _binRe[peak - 1] + _binIm[peak - 1] * _binIm[peak - 1]);
+      float b = sqrtf(peakPower);
+      float c = sqrtf(_binRe[peak + 1] * _binRe[peak + 1] + _binIm[peak + 1] * _binIm[peak + 1]);
+      float d = a - 2 * b + c;
+      if(d < 0) shift = 0.5f * (a - c) / d;
+    }
+
+    _bpm = (_firstBin + peak + shift) * _samplingRate / kWindow * 60.0f;
+    _confidence = peakPower > 0 ? 1.0f - secondPower / peakPower : 0;
+    return true;
+  }
+
+  /**
+   * Heart rate of the last estimate
+   * @return Heart rate in BPM or NaN
+   */
+  float bpm() const {
+    return _bpm;
+  }
+
+  /**
+   * Confidence of the last estimate
+   * @return Peak prominence between 0 (competing peak of equal power) and 1 (single peak)
+   */
+  float confidence() const {
+    return _confidence;
+  }
+};
+
+#endif
@@ -0,0 +1,110 @@
+/*!
+ * @file MAX3010x_spo2Calibration.h
+ */
+
+
+#ifndef _MAX3010x_SPO2_CALIBRATION_H
+#define _MAX3010x_SPO2_CALIBRATION_H
+
+#include <stdint.h>
+
+#include "MAX3010x_spo2Fixed.h"
+
+/**
+ * Temperature Compensated SpO2 Calibration
+ *
+ * The wavelength of the red LED shifts with its temperature, which biases the ratio of ratios R
+ * and thereby the R to SpO2 calibration curve. The bias is modelled as a relative drift of R:
+ * R_measured = R * (1 + ratioDrift * (T - referenceTemperature)).
+ *
+ * setTemperature() computes the correction 1 / (1 + ratioDrift * (T - referenceTemperature)) once per
+ * temperature reading in Q14 format. spo2() scales R (Q10, see MAX3010xRatio::q10()) by the correction
+ * and looks up the calibration curve in the compile-time table of MAX3010xSpO2Lookup (in flash on AVR),
+ * so no floating point code runs per beat and no table is kept in RAM.
+ * The die temperature can be sampled without blocking using requestTemperature() and poll().
+ *
+ * Usage:
+ * @code
+ * MAX3010xSpO2Calibration<> calibration(0.002f);   // 0.2 % drift of R per °C
+ * calibration.setTemperature(sensor.polledTemperature());
+ * uint16_t spo2 = calibration.spo2(MAX3010xRatio::q10(stat_red.ac(), stat_red.dc(), stat_ir.ac(), stat_ir.dc()));   // Q8, 256 = 1 %
+ * @endcode
+ *
+ * @tparam Calibration Struct with the constexpr factors a, b and c (see MAX3010xMaximSpO2Calibration)
+ * @tparam kStepShift Table step of the lookup as power of two in Q10 (5: R / 32)
+ */
+template<class Calibration = MAX3010xMaximSpO2Calibration, uint8_t kStepShift = 5> class MAX3010xSpO2Calibration {
+public:
+  static const uint8_t CORRECTION_SHIFT = 14;     //!< Fractional bits of the R correction
+
+private:
+  typedef MAX3010xSpO2Lookup<Calibration, kStepShift> Lookup;
+
+  float _ratioDrift;              //!< Relative drift of R per °C
+  float _referenceTemperature;    //!< Die temperature during calibration in °C
+  uint16_t _correction;           //!< R correction for the current temperature (Q14)
+public:
+  /**
+   * Constructor
+   * @param ratioDrift Relative drift of R per °C (determined by calibration, 0 disables the compensation)
+   * @param referenceTemperature Die temperature during calibration in °C
+   */
+  MAX3010xSpO2Calibration(float ratioDrift = 0, float referenceTemperature = 25) {
+    configure(ratioDrift, referenceTemperature);
+  }
+
+  /**
+   * Set the temperature drift
+   * @remarks The correction is reset to the reference temperature
+   * @param ratioDrift Relative drift of R per °C (0 disables the compensation)
+   * @param referenceTemperature Die temperature during calibration in °C
+   */
+  void configure(float ratioDrift = 0, float referenceTemperature = 25) {
+    _ratioDrift = ratioDrift;
+    _referenceTemperature = referenceTemperature;
+    _correction = 1 << CORRECTION_SHIFT;
+  }
+
+  /**
+   * Set the current die temperature
+   * @remarks The correction is limited to 0.5 - 2
+   * @param temperature Temperature in °C (NaN is ignored)
+   */
+  void setTemperature(float temperature) {
+    if(temperature != temperature) return;
+
+    const float drift = 1.0f + _ratioDrift * (temperature - _referenceTemperature);
+    const float correction = drift > 2.0f ? 0.5f : drift < 0.5f ? 2.0f : 1.0f / drift;
+    _correction = static_cast<uint16_t>(correction * (1 << CORRECTION_SHIFT) + 0.5f);
+  }
+
+  /**
+   * R correction for the current temperature
+   * @return Factor in Q14 format (16384 = 1.0)
+   */
+  uint16_t correction() const {
+    return _correction;
+  }
+
+  /**
+   * Compensated SpO2
+   * @param ratio Ratio of ratios R = (AC_red / DC_red) / (AC_ir / DC_ir) in Q10 format (see MAX3010xRatio::q10())
+   * @return SpO2 in Q8 format (256 = 1 %)
+   */
+  uint16_t spo2(uint16_t ratio) const {
+    const uint32_t corrected = (static_cast<uint32_t>(ratio) * _correction) >> CORRECTION_SHIFT;
+    return Lookup::spo2(corrected > 0xFFFF ? 0xFFFF : corrected);
+  }
+
+  /**
+   * Compensated SpO2 from the pulse statistics
+   * @param red Statistic of the red channel
+   * @param ir Statistic of the IR channel
+   * @return SpO2 in Q8 format (256 = 1 %)
+   */
+  uint16_t spo2(const MAX3010xPulseStatistic& red, const MAX3010xPulseStatistic& ir) const {
+    return spo2(MAX3010xRatio::q10(red.ac(), red.dc(), ir.ac(), ir.dc()));
+  }
+};
+
+#endif
@@ -0,0 +1,227 @@
+/*!
+ * @file MAX3010x_spo2Fixed.h
+ */
+
+
+#ifndef _MAX3010x_SPO2_FIXED_H
+#define _MAX3010x_SPO2_FIXED_H
+
+#include <stdint.h>
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define MAX3010x_TABLE_ATTR PROGMEM                             //!< Place lookup tables in flash
+#define MAX3010x_TABLE_READ(entry) pgm_read_word(&(entry))      //!< Read a lookup table entry
+#else
+#define MAX3010x_TABLE_ATTR                                     //!< Place lookup tables in flash
+#define MAX3010x_TABLE_READ(entry) (entry)                      //!< Read a lookup table entry
+#endif
+
+/**
+ * Integer Min/Max/Sum Statistic
+ *
+ * Integer counterpart of the min/max/average statistic of the examples. Accumulates the
+ * values of one beat to derive the pulsatile (AC) and constant (DC) component.
+ * At most 16383 18-bit values can be accumulated.
+ */
+class MAX3010xPulseStatistic {
+  uint32_t _min;      //!< Minimum value
+  uint32_t _max;      //!< Maximum value
+  uint32_t _sum;      //!< Sum of all values
+  uint16_t _count;    //!< Number of values
+public:
+  MAX3010xPulseStatistic() {
+    reset();
+  }
+
+  /**
+   * Add a value
+   * @param value Value
+   */
+  void process(uint32_t value) {
+    if(_count == 0x3FFF) return;
+    if(value < _min) _min = value;
+    if(value > _max) _max = value;
+    _sum += value;
+    _count++;
+  }
+
+  /**
+   * Resets the stored values
+   */
+  void reset() {
+    _min = UINT32_MAX;
+    _max = 0;
+    _sum = 0;
+    _count = 0;
+  }
+
+  /**
+   * Pulsatile component
+   * @return Maximum - minimum (0 without values)
+   */
+  uint32_t ac() const {
+    return _count > 0 ? _max - _min : 0;
+  }
+
+  /**
+   * Constant component
+   * @return Average value (0 without values)
+   */
+  uint32_t dc() const {
+    return _count > 0 ? _sum / _count : 0;
+  }
+};
+
+/**
+ * Integer Ratio of Ratios
+ *
+ * Computes R = (AC_red / DC_red) / (AC_ir / DC_ir) = (AC_red * DC_ir) / (DC_red * AC_ir) in Q10 format
+ * with a single 32 bit integer division. Pairs of values are scaled down by a common power of two,
+ * which does not change the ratio, so that all products fit into 32 bits. The relative error is below 0.05 %.
+ */
+struct MAX3010xRatio {
+  static const uint8_t SHIFT = 10;      //!< Fractional bits of the ratio
+
+  /**
+   * Scale a pair of values by a common power of two until both fit into a number of bits
+   * @param a First value
+   * @param b Second value
+   * @param bits Number of bits
+   */
+  static void normalize(uint32_t& a, uint32_t& b, uint8_t bits) {
+    while((a | b) >> bits) {
+      a >>= 1;
+      b >>= 1;
+    }
+  }
+
+  /**
+   * Ratio of ratios
+   * @param acRed Pulsatile component of the red channel
+   * @param dcRed Constant component of the red channel
+   * @param acIr Pulsatile component of the IR channel
+   * @param dcIr Constant component of the IR channel
+   * @return R in Q10 format (1024 = 1.0), 0 if undefined, saturated at 0xFFFF
+   */
+  static uint16_t q10(uint32_t acRed, uint32_t dcRed, uint32_t acIr, uint32_t dcIr) {
+    normalize(acRed, acIr, 16);
+    normalize(dcRed, dcIr, 16);
+
+    uint32_t numerator = acRed * dcIr;
+    uint32_t denominator = dcRed * acIr;
+    normalize(numerator, denominator, 32 - SHIFT);
+    if(denominator == 0) return 0;
+
+    const uint32_t ratio = (numerator << SHIFT) / denominator;
+    return ratio > 0xFFFF ? 0xFFFF : ratio;
+  }
+};
+
+/**
+ * Calibration of the Maxim application note 6845
+ * SpO2 = a * R^2 + b * R + c
+ */
+struct MAX3010xMaximSpO2Calibration {
+  static constexpr float a = 1.5958422f;     //!< Quadratic factor
+  static constexpr float b = -34.6596622f;   //!< Linear factor
+  static constexpr float c = 112.6898759f;   //!< Constant factor
+};
+
+/**
+ * Index Sequence (compile-time table generation)
+ */
+template<uint16_t... I> struct MAX3010xIndices {};
+
+/**
+ * Generates MAX3010xIndices<0, ..., N - 1>
+ */
+template<uint16_t N, uint16_t... I> struct MAX3010xMakeIndices : MAX3010xMakeIndices<N - 1, N - 1, I...> {};
+template<uint16_t... I> struct MAX3010xMakeIndices<0, I...> {
+  typedef MAX3010xIndices<I...> type;
+};
+
+/**
+ * Integer SpO2 Lookup
+ *
+ * The calibration curve SpO2 = a * R^2 + b * R + c is tabulated at compile time, no floating point
+ * code is generated for the lookup. The table is stored in flash on AVR. Between the table entries
+ * the value is interpolated linearly. With the default step (R / 32) the deviation from the float
+ * calculation is below 0.1 % SpO2, together with the quantization of R (MAX3010xRatio) below 0.25 % SpO2.
+ *
+ * Usage:
+ * @code
+ * uint16_t r = MAX3010xRatio::q10(stat_red.ac(), stat_red.dc(), stat_ir.ac(), stat_ir.dc());
+ * uint16_t spo2 = MAX3010xSpO2Lookup<>::spo2(r);   // Q8, 256 = 1 %
+ * @endcode
+ *
+ * @tparam Calibration Struct with the constexpr factors a, b and c (see MAX3010xMaximSpO2Calibration)
+ * @tparam kStepShift Table step as power of two in Q10 (5: R / 32)
+ * @tparam kMaxRatio Largest tabulated R in Q10, larger values are clamped
+ */
+template<class Calibration = MAX3010xMaximSpO2Calibration, uint8_t kStepShift = 5, uint16_t kMaxRatio = 3 << MAX3010xRatio::SHIFT> class MAX3010xSpO2Lookup {
+public:
+  static const uint16_t ENTRIES = (kMaxRatio >> kStepShift) + 1;   //!< Number of table entries
+
+private:
+  /**
+   * Clamp and convert a SpO2 value
+   * @param spo2 SpO2 in %
+   * @return SpO2 in Q8 format (0 - 100 %)
+   */
+  static constexpr uint16_t q8(float spo2) {
+    return spo2 <= 0 ? 0 : spo2 >= 100 ? 100 << 8 : static_cast<uint16_t>(spo2 * 256.0f + 0.5f);
+  }
+
+  /**
+   * Table entry
+   * @param ratio R
+   * @return SpO2 in Q8 format
+   */
+  static constexpr uint16_t entry(float ratio) {
+    return q8(Calibration::a * ratio * ratio + Calibration::b * ratio + Calibration::c);
+  }
+
+  /**
+   * Table storage
+   */
+  template<class Indices> struct Table;
+  template<uint16_t... I> struct Table<MAX3010xIndices<I...>> {
+    static const uint16_t values[ENTRIES];   //!< SpO2 in Q8 format
+  };
+
+  typedef Table<typename MAX3010xMakeIndices<ENTRIES>::type> Values;
+public:
+  /**
+   * SpO2 for a ratio
+   * @param ratio R in Q10 format (see MAX3010xRatio::q10())
+   * @return SpO2 in Q8 format (256 = 1 %)
+   */
+  static uint16_t spo2(uint16_t ratio) {
+    if(ratio >= kMaxRatio) return MAX3010x_TABLE_READ(Values::values[ENTRIES - 1]);
+
+    const uint16_t index = ratio >> kStepShift;
+    const int32_t fraction = ratio & ((1 << kStepShift) - 1);
+    const int32_t lower = MAX3010x_TABLE_READ(Values::values[index]);
+    const int32_t upper = MAX3010x_TABLE_READ(Values::values[index + 1]);
+    return lower + (((upper - lower) * fraction) >> kStepShift);
+  }
+
+  /**
+   * SpO2 from the pulse statistics
+   * @param red Statistic of the red channel
+   * @param ir Statistic of the IR channel
+   * @return SpO2 in Q8 format (256 = 1 %)
+   */
+  static uint16_t spo2(const MAX3010xPulseStatistic& red, const MAX3010xPulseStatistic& ir) {
+    return spo2(MAX3010xRatio::q10(red.ac(), red.dc(), ir.ac(), ir.dc()));
+  }
+};
+
+template<class Calibration, uint8_t kStepShift, uint16_t kMaxRatio>
+template<uint16_t... I>
+const uint16_t MAX3010xSpO2Lookup<Calibration, kStepShift, kMaxRatio>::Table<MAX3010xIndices<I...>>::values[ENTRIES] MAX3010x_TABLE_ATTR = {
+  MAX3010xSpO2Lookup<Calibration, kStepShift, kMaxRatio>::entry(static_cast<float>(I << kStepShift) / (1 << MAX3010xRatio::SHIFT))...
+};
+
+#endif
@@ -0,0 +1,298 @@
+/*!
+ * @file MAX3010x_syncGroup.h
+ */
+
+
+#ifndef _MAX3010x_SYNC_GROUP_H
+#define _MAX3010x_SYNC_GROUP_H
+
+#include "MAX3010x_core.h"
+#include "MAX3010x_clock.h"
+
+/**
+ * Synchronised Multi-Sensor Acquisition
+ *
+ * Drains several sensors and maps their samples to the host timeline. Each sensor runs on its own
+ * oscillator, so its sample clock is tracked with a MAX3010xClockEstimator fed by the FIFO pointer
+ * observations of every drain. Output frames are generated on a common time grid, the values of
+ * each sensor are linearly interpolated between the two samples surrounding the frame time.
+ *
+ * The history has to hold the samples of a full FIFO (32) plus the last sample before them, otherwise
+ * a drain overwrites samples still needed for interpolation. Frames that can't be interpolated for all
+ * sensors (after lost samples or a history overrun) are skipped and counted in skippedFrames().
+ *
+ * Usage:
+ * @code
+ * MAX3010xSyncGroup<2> group(400);
+ * group.attach(0, finger, 400);
+ * group.attach(1, ear, 400);
+ * ...
+ * group.update([](const MAX3010xSyncGroup<2>::Frame& frame) {
+ *   // frame.value[sensor][slot] at frame.time
+ * });
+ * @endcode
+ *
+ * @tparam kSensors Number of sensors
+ * @tparam kSlots Number of slots stored per sample
+ * @tparam kHistory Number of samples buffered per sensor (at least the FIFO size + 1)
+ */
+template<uint8_t kSensors, uint8_t kSlots = 2, uint8_t kHistory = 33> class MAX3010xSyncGroup {
+  static_assert(kSensors > 0, "At least one sensor is required");
+  static_assert(kHistory > 1, "History is too short");
+
+  /**
+   * Per-Sensor State
+   */
+  struct Channel {
+    void* sensor;                           //!< Sensor instance
+    void (*drain)(Channel& channel);        //!< Drain function for the sensor type
+    MAX3010xClockEstimator clock;           //!< Sample clock of the sensor
+    uint32_t first;                         //!< Sample index of the oldest buffered sample
+    uint8_t tail;                           //!< Buffer index of the oldest sample
+    uint8_t count;                          //!< Number of buffered samples
+    float values[kHistory][kSlots];         //!< Buffered sample values (ring buffer)
+
+    Channel() : sensor(nullptr), drain(nullptr), clock(100), first(0), tail(0), count(0) {}
+
+    /**
+     * Buffer a sample
+     * @param index Sample index
+     * @param raw Raw FIFO data
+     * @param sample Sample within the raw data
+     */
+    void push(uint32_t index, const MAX3010xRawData& raw, uint8_t sample) {
+      // Samples lost due to an overflow invalidate the buffer
+      if(count > 0 && index != first + count) count = 0;
+      if(count == 0) {
+        first = index;
+        tail = 0;
+      }
+      else if(count == kHistory) {
+        first++;
+        tail = tail + 1 == kHistory ? 0 : tail + 1;
+        count--;
+      }
+
+      float* value = values[(tail + count) % kHistory];
+      for(uint8_t slot = 0; slot < kSlots; slot++) {
+        value[slot] = slot < raw.slots ? raw.value(sample, slot) : 0;
+      }
+      count++;
+    }
+
+    /**
+     * Discard the oldest sample
+     */
+    void pop() {
+      first++;
+      tail = tail + 1 == kHistory ? 0 : tail + 1;
+      count--;
+    }
+
+    /**
+     * Buffered sample values
+     * @param i Sample offset relative to the oldest sample
+     * @return Sample values
+     */
+    const float* at(uint8_t i) const {
+      return values[(tail + i) % kHistory];
+    }
+
+    /**
+     * Time of a buffered sample relative to a reference time
+     * @param i Sample offset relative to the oldest sample
+     * @param time Reference time in us
+     * @return Time difference in us
+     */
+    int32_t offset(uint8_t i, uint32_t time) const {
+      return static_cast<int32_t>(clock.timestamp(first + i) - time);
+    }
+  };
+
+  /**
+   * Drain a sensor into its channel
+   * @tparam Sensor Sensor type
+   * @param channel Channel
+   */
+  template<class Sensor> static void drainSensor(Channel& channel) {
+    Sensor& sensor = *static_cast<Sensor*>(channel.sensor);
+    sensor.drainRaw([&](const MAX3010xRawData& raw) {
+      // The counters already include this batch
+      uint32_t index = sensor.samplesRead() + sensor.samplesLost() + sensor.samplesDiscarded() - raw.samples;
+      for(uint8_t i = 0; i < raw.samples; i++) channel.push(index + i, raw, i);
+    });
+    channel.clock.observe(sensor.observedMicros(), sensor.observedSamples());
+  }
+
+  Channel _channels[kSensors];    //!< Sensors
+  float _period;                  //!< Frame period in us
+  uint32_t _frameTime;            //!< Time of the next frame in us
+  float _frameFraction;           //!< Fractional part of the next frame time in us
+  bool _started;                  //!< Frame time initialized
+  uint32_t _skippedFrames;        //!< Frames skipped because not all sensors covered them
+
+  /**
+   * Advance to the next frame time
+   */
+  void nextFrame() {
+    _frameFraction += _period;
+    uint32_t whole = static_cast<uint32_t>(_frameFraction);
+    _frameTime += whole;
+    _frameFraction -= whole;
+  }
+public:
+  /**
+   * Output Frame
+   */
+  struct Frame {
+    uint32_t time;                        //!< Frame time in us (micros())
+    float value[kSensors][kSlots];        //!< Interpolated values per sensor and slot
+  };
+
+  /**
+   * Constructor
+   * @param frameRate Output frame rate in Hz
+   */
+  MAX3010xSyncGroup(float frameRate) : _period(1e6f / frameRate), _frameTime(0), _frameFraction(0), _started(false), _skippedFrames(0) {}
+
+  /**
+   * Attach a sensor
+   * @remarks The sensor needs to be configured (sampling rate, averaging, mode) before samples are drained.
+   * @param index Sensor index in the output frames
+   * @param sensor Sensor instance
+   * @param samplingRate Nominal sampling rate of the sensor in Hz (after on-chip averaging)
+   * @return true if successful, otherwise false
+   */
+  template<class Sensor> bool attach(uint8_t index, Sensor& sensor, float samplingRate) {
+    if(index >= kSensors) return false;
+
+    Channel& channel = _channels[index];
+    channel.sensor = &sensor;
+    channel.drain = &drainSensor<Sensor>;
+    channel.clock = MAX3010xClockEstimator(samplingRate);
+    channel.count = 0;
+    _started = false;
+    return true;
+  }
+
+  /**
+   * Drain all sensors and output the frames that can be interpolated
+   * @param callback Function or function object accepting a const Frame&
+   * @return Number of frames
+   */
+  template<class Callback> uint8_t update(Callback callback) {
+    for(uint8_t s = 0; s < kSensors; s++) {
+      if(_channels[s].drain) _channels[s].drain(_channels[s]);
+    }
+
+    // Wait for data and a sample clock estimate of all sensors
+    for(uint8_t s = 0; s < kSensors; s++) {
+      if(_channels[s].count < 2 || _channels[s].clock.observations() < 2) return 0;
+    }
+
+    if(!_started) {
+      // Start at the newest common sample
+      _frameTime = _channels[0].clock.timestamp(_channels[0].first);
+      for(uint8_t s = 1; s < kSensors; s++) {
+        uint32_t start = _channels[s].clock.timestamp(_channels[s].first);
+        if(static_cast<int32_t>(start - _frameTime) > 0) _frameTime = start;
+      }
+      _frameFraction = 0;
+      _started = true;
+    }
+
+    Frame frame;
+    uint8_t frames = 0;
+    while(true) {
+      bool ready = true;
+      for(uint8_t s = 0; s < kSensors && ready; s++) {
+        Channel& channel = _channels[s];
+
+        // Drop samples that are no longer needed
+        while(channel.count > 2 && channel.offset(1, _frameTime) <= 0) channel.pop();
+
+        if(channel.offset(channel.count - 1, _frameTime) < 0) ready = false;
+      }
+      if(!ready) break;
+
+      // Skip frames not covered by all sensors (e.g. after samples were lost)
+      bool covered = true;
+      for(uint8_t s = 0; s < kSensors; s++) {
+        int32_t gap = _channels[s].offset(0, _frameTime);
+        if(gap > 0) {
+          _skippedFrames += static_cast<uint32_t>(ceilf(gap / _period));
+          _frameTime += gap;
+          _frameFraction = 0;
+          covered = false;
+        }
+      }
+      if(!covered) continue;
+
+      frame.time = _frameTime;
+      for(uint8_t s = 0; s < kSensors; s++) {
+        const Channel& channel = _channels[s];
+        uint8_t i = 0;
+        while(i + 2 < channel.count && channel.offset(i + 1, _frameTime) <= 0) i++;
+
+        const int32_t t0 = channel.offset(i, _frameTime);
+        const int32_t t1 = channel.offset(i + 1, _frameTime);
+        const float w = t1 > t0 ? static_cast<float>(-t0) / (t1 - t0) : 0;
+        const float* v0 = channel.at(i);
+        const float* v1 = channel.at(i + 1);
+        for(uint8_t slot = 0; slot < kSlots; slot++) {
+          frame.value[s][slot] = v0[slot] + w * (v1[slot] - v0[slot]);
+        }
+      }
+
+      callback(static_cast<const Frame&>(frame));
+      frames++;
+      nextFrame();
+    }
+
+    return frames;
+  }
+
+  /**
+   * Number of skipped frames
+   * @remarks Frame periods not covered by the buffered samples of all sensors, e.g. after a FIFO overflow
+   * @return Number of frames
+   */
+  uint32_t skippedFrames() const {
+    return _skippedFrames;
+  }
+
+  /**
+   * Sample clock of a sensor
+   * @param index Sensor index
+   * @return Clock estimator
+   */
+  const MAX3010xClockEstimator& clock(uint8_t index) const {
+    return _channels[index].clock;
+  }
+
+  /**
+   * Residual timing error of a sensor
+   * @param index Sensor index
+   * @return Smoothed absolute deviation of the FIFO observations from the estimated sample clock in us
+   */
+  float residual(uint8_t index) const {
+    return _channels[index].clock.residual();
+  }
+
+  /**
+   * Residual alignment error between the sensors
+   * @remarks
+   * Root sum square of the residuals of all sensor clocks. The observation jitter is part of the residuals,
+   * so this is a conservative estimate of the relative timing error of the interpolated frames.
+   * @return Alignment error in us
+   */
+  float alignmentError() const {
+    float sum = 0;
+    for(uint8_t s = 0; s < kSensors; s++) {
+      sum += _channels[s].clock.residual() * _channels[s].clock.residual();
+    }
+    return sqrtf(sum);
+  }
+};
+
+#endif
@@ -0,0 +1,284 @@
+/*!
+ * @file MAX3010x_transport.h
+ */
+
+
+#ifndef _MAX3010x_TRANSPORT_H
+#define _MAX3010x_TRANSPORT_H
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#ifndef MAX3010x_I2C_BUFFER_SIZE
+#define MAX3010x_I2C_BUFFER_SIZE 32   //!< Size of the I2C receive buffer, limits the length of burst reads
+#endif
+
+/**
+ * Transport Interface
+ *
+ * Bus access used by the sensor drivers. The default implementation (MAX3010xWireTransport) uses
+ * the blocking Arduino Wire API. Transports for DMA capable I2C peripherals can override readAsync()
+ * to return immediately and report the completion later.
+ */
+class MAX3010xTransport {
+protected:
+  uint8_t _lastError;   //!< Error of the last failed transfer (see Error)
+public:
+  /**
+   * Bus Errors
+   */
+  enum Error {
+    ERROR_NONE,           //!< No error
+    ERROR_ADDRESS_NACK,   //!< Address not acknowledged
+    ERROR_DATA_NACK,      //!< Data not acknowledged
+    ERROR_SHORT_READ,     //!< Fewer bytes received than requested
+    ERROR_TIMEOUT,        //!< Bus timeout
+    ERROR_OTHER           //!< Other or unknown error
+  };
+
+  /**
+   * Completion Callback
+   * @param context User context
+   * @param success true if the transfer was successful, otherwise false
+   */
+  typedef void (*Callback)(void* context, bool success);
+
+  /**
+   * Constructor
+   */
+  MAX3010xTransport() : _lastError(ERROR_NONE) {}
+
+  /**
+   * Destructor
+   */
+  virtual ~MAX3010xTransport() {}
+
+  /**
+   * Error of the last failed transfer
+   * @remarks Transports that do not report errors leave this at ERROR_NONE
+   * @return Error (see Error)
+   */
+  uint8_t lastError() const {
+    return _lastError;
+  }
+
+  /**
+   * Initializes the bus
+   */
+  virtual void begin() = 0;
+
+  /**
+   * Read Block
+   * @param addr I2C Device Address
+   * @param reg Register
+   * @param count Number of bytes to read
+   * @param buffer Buffer for values
+   * @return true if successful, otherwise false
+   */
+  virtual bool read(uint8_t addr, uint8_t reg, uint8_t count, uint8_t* buffer) = 0;
+
+  /**
+   * Write Block
+   * @param addr I2C Device Address
+   * @param reg Register
+   * @param count Number of bytes to write
+   * @param buffer Buffer with values
+   * @return true if successful, otherwise false
+   */
+  virtual bool write(uint8_t addr, uint8_t reg, uint8_t count, const uint8_t* buffer) = 0;
+
+  /**
+   * Start an asynchronous read
+   * @remarks
+   * The default implementation performs a blocking read and calls the callback before returning.
+   * Asynchronous implementations may call the callback from interrupt context.
+   * @param addr I2C Device Address
+   * @param reg Register
+   * @param count Number of bytes to read (at most maxTransferSize())
+   * @param buffer Buffer for values, must stay valid until completion
+   * @param callback Completion callback
+   * @param context User context passed to the callback
+   * @return true if the transfer was started, otherwise false
+   */
+  virtual bool readAsync(uint8_t addr, uint8_t reg, uint8_t count, uint8_t* buffer, Callback callback, void* context) {
+    callback(context, read(addr, reg, count, buffer));
+    return true;
+  }
+
+  /**
+   * Set the bus clock
+   * @param clock I2C clock in Hz
+   * @return true if the clock was set, false if not supported
+   */
+  virtual bool setClock(uint32_t clock) {
+    (void)clock;
+    return false;
+  }
+
+  /**
+   * Clear a stuck bus
+   * @remarks Called by the bus error recovery (see MAX3010xRecoveryPolicy). The default implementation does nothing.
+   * @return true if the bus is free, otherwise false
+   */
+  virtual bool recoverBus() {
+    return false;
+  }
+
+  /**
+   * Maximum number of bytes per read transfer
+   * @return Maximum transfer size in bytes
+   */
+  virtual uint8_t maxTransferSize() {
+    return MAX3010x_I2C_BUFFER_SIZE;
+  }
+};
+
+/**
+ * Transport using the Arduino Wire API
+ */
+class MAX3010xWireTransport : public MAX3010xTransport {
+  friend class MAX3010xBase; //!< Friend declaration for the unbound placeholder of sensors using a custom transport
+
+  TwoWire* _wire;      //!< I2C Bus Implementation (nullptr if unbound)
+  int _sdaPin;         //!< SDA Pin for bus clears (-1 if unknown)
+  int _sclPin;         //!< SCL Pin for bus clears (-1 if unknown)
+  uint32_t _clock;     //!< Clock set with setClock() in Hz (0 if platform default)
+public:
+  /**
+   * Constructor
+   * @param wire TWI bus instance
+   * @param sdaPin SDA Pin, required for bus clears (-1 if unknown)
+   * @param sclPin SCL Pin, required for bus clears (-1 if unknown)
+   */
+  MAX3010xWireTransport(TwoWire& wire, int sdaPin = -1, int sclPin = -1) : _wire(&wire), _sdaPin(sdaPin), _sclPin(sclPin), _clock(0) {}
+
+private:
+  /**
+   * Constructor
+   * Unbound transport, placeholder in sensors using a custom transport (no reference to the global Wire instance)
+   */
+  MAX3010xWireTransport() : _wire(nullptr), _sdaPin(-1), _sclPin(-1), _clock(0) {}
+
+public:
+
+  /**
+   * Map the result of TwoWire::endTransmission() to a bus error
+   * @param result Result of endTransmission()
+   * @return Error
+   */
+  static uint8_t transmissionError(uint8_t result) {
+    switch(result) {
+      case 0: return ERROR_NONE;
+      case 2: return ERROR_ADDRESS_NACK;
+      case 3: return ERROR_DATA_NACK;
+      case 5: return ERROR_TIMEOUT;
+      default: return ERROR_OTHER;
+    }
+  }
+
+  /**
+   * Initializes the bus (Wire.begin())
+   */
+  void begin() override {
+    _wire->begin();
+  }
+
+  /**
+   * Set the bus clock (Wire.setClock())
+   * @param clock I2C clock in Hz
+   * @return true
+   */
+  bool setClock(uint32_t clock) override {
+    _wire->setClock(clock);
+    _clock = clock;
+    return true;
+  }
+
+  /**
+   * Read Block
+   * @param addr I2C Device Address
+   * @param reg Register
+   * @param count Number of bytes to read
+   * @param buffer Buffer for values
+   * @return true if successful, otherwise false
+   */
+  bool read(uint8_t addr, uint8_t reg, uint8_t count, uint8_t* buffer) override {
+    _wire->beginTransmission(addr);
+    _wire->write(byte(reg));
+    _lastError = transmissionError(_wire->endTransmission(true));
+    if(_lastError != ERROR_NONE) return false;
+
+    if(_wire->requestFrom(addr, count) != count || _wire->available() != count) {
+      _lastError = ERROR_SHORT_READ;
+      return false;
+    }
+
+    for(int i = 0; i < count; i++) {
+      buffer[i] = _wire->read();
+    }
+
+    return true;
+  }
+
+  /**
+   * Write Block
+   * @param addr I2C Device Address
+   * @param reg Register
+   * @param count Number of bytes to write
+   * @param buffer Buffer with values
+   * @return true if successful, otherwise false
+   */
+  bool write(uint8_t addr, uint8_t reg, uint8_t count, const uint8_t* buffer) override {
+    _wire->beginTransmission(addr);
+    _wire->write(reg);
+    for(int i = 0; i < count; i++) {
+      _wire->write(buffer[i]);
+    }
+
+    _lastError = transmissionError(_wire->endTransmission(true));
+    return _lastError == ERROR_NONE;
+  }
+
+  /**
+   * Clear a stuck bus
+   * @remarks
+   * A slave holding SDA low (e.g. after an interrupted read) is released by clocking SCL up to
+   * nine times followed by a STOP condition. The pins are driven open-drain, the bus is reinitialized afterwards
+   * with the clock last set by setClock().
+   * Requires the SDA and SCL pins to be passed to the constructor.
+   * @return true if the bus is free, false if it is still stuck or the pins are unknown
+   */
+  bool recoverBus() override {
+    if(_sdaPin < 0 || _sclPin < 0) return false;
+
+#ifdef WIRE_HAS_END
+    _wire->end();
+#endif
+
+    pinMode(_sdaPin, INPUT_PULLUP);
+    pinMode(_sclPin, INPUT_PULLUP);
+    delayMicroseconds(5);
+
+    for(uint8_t i = 0; i < 9 && digitalRead(_sdaPin) == LOW; i++) {
+      digitalWrite(_sclPin, LOW);
+      pinMode(_sclPin, OUTPUT);
+      delayMicroseconds(5);
+      pinMode(_sclPin, INPUT_PULLUP);
+      delayMicroseconds(5);
+    }
+
+    // STOP condition: SDA rising while SCL is high
+    digitalWrite(_sdaPin, LOW);
+    pinMode(_sdaPin, OUTPUT);
+    delayMicroseconds(5);
+    pinMode(_sdaPin, INPUT_PULLUP);
+    delayMicroseconds(5);
+
+    bool released = digitalRead(_sdaPin) == HIGH;
+    _wire->begin();
+    if(_clock != 0) _wire->setClock(_clock);
+    return released;
+  }
+};
+
+#endif